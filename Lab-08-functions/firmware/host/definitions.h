@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/** Host stand-in for definitions.h
+
+  @File Name
+    definitions.h
+
+  @Summary
+    Lets the pure C parts of ../src build and run on a PC.
+
+  @Description
+    The host Makefile puts this directory first on the include path, so
+    testFuncs.c, testRunner.c and randVectors.c get this file instead of
+    the Harmony one in ../src/config/sam_e51_cnano. It keeps the device
+    types (so the TRNG and NVMCTRL plibs and their models in trngSim.c
+    and nvmSim.c still build), but nothing that
+    touches real hardware: DWT is a fake whose CYCCNT counts 120 MHz
+    cycles of the host clock, and the LED is a no-op.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _HOST_DEFINITIONS_H    /* Guard against multiple inclusion */
+#define _HOST_DEFINITIONS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+// core_cm4.h casts 32 bit register values to pointers (NVIC vectors),
+// which warns on a 64 bit PC. It's vendor code and never called here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+#include "device.h"
+#pragma GCC diagnostic pop
+#include "peripheral/trng/plib_trng.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// same as the target, so cycles and cycles/sec mean the same thing
+#define CPU_CLOCK_FREQUENCY 120000000
+
+// core_cm4.h points DWT at the real registers; the host one is in
+// hostStubs.c. Only CYCCNT is used by ../src.
+typedef struct _hostDwtRegs
+{
+    volatile uint32_t CYCCNT;
+} hostDwtRegs;
+
+// update CYCCNT from the host clock and return the registers
+hostDwtRegs *hostDwt(void);
+
+#undef DWT
+#define DWT (hostDwt())
+
+#define LED0_Toggle()   do { } while (0)
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HOST_DEFINITIONS_H */
+
+/* *****************************************************************************
+ End of File
+ */
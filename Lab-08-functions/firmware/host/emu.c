@@ -0,0 +1,489 @@
+/* ************************************************************************** */
+/** Cortex-M4 emulator for the built firmware
+
+  @File Name
+    emu.c
+
+  @Summary
+    See emu.h. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <unicorn/unicorn.h>
+#include "emu.h"
+
+// cycles to refill the pipeline after a taken branch. The TRM gives
+// 1 to 3; 2 is the usual case for a branch to a word-aligned target.
+#define EMU_BRANCH_REFILL   2
+
+// first and last SDIV/UDIV cycles (TRM: 2 to 12, early termination)
+#define EMU_DIV_MIN_CYCLES  2
+#define EMU_DIV_MAX_CYCLES  12
+
+static const int armRegs[16] = {
+    UC_ARM_REG_R0, UC_ARM_REG_R1, UC_ARM_REG_R2, UC_ARM_REG_R3,
+    UC_ARM_REG_R4, UC_ARM_REG_R5, UC_ARM_REG_R6, UC_ARM_REG_R7,
+    UC_ARM_REG_R8, UC_ARM_REG_R9, UC_ARM_REG_R10, UC_ARM_REG_R11,
+    UC_ARM_REG_R12, UC_ARM_REG_SP, UC_ARM_REG_LR, UC_ARM_REG_PC,
+};
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static uint32_t regRead(uc_engine *uc, uint32_t n)
+{
+    uint32_t v = 0;
+    uc_reg_read(uc, armRegs[n & 15], &v);
+    return v;
+}
+
+
+// copy an ELF segment into flash or RAM, if it lands in one of them
+static void loadSegment(emuImage *img, uint32_t addr, const uint8_t *bytes,
+        uint32_t len)
+{
+    if ((addr >= EMU_FLASH_ADDR) && (addr - EMU_FLASH_ADDR + len <= EMU_FLASH_SIZE))
+    {
+        memcpy(img->flash + (addr - EMU_FLASH_ADDR), bytes, len);
+    }
+    else if ((addr >= EMU_SRAM_ADDR) && (addr - EMU_SRAM_ADDR + len <= EMU_SRAM_SIZE))
+    {
+        memcpy(img->sram + (addr - EMU_SRAM_ADDR), bytes, len);
+    }
+}
+
+
+// SDIV/UDIV stop early once the quotient bits run out, so the cost
+// goes with how many more bits the dividend has than the divisor
+static uint32_t divCycles(uc_engine *uc, uint16_t hw1, uint16_t hw2, bool isSigned)
+{
+    uint32_t n = regRead(uc, hw1 & 0xF);
+    uint32_t d = regRead(uc, hw2 & 0xF);
+
+    if (isSigned)
+    {
+        n = ((int32_t)n < 0) ? 0U - n : n;
+        d = ((int32_t)d < 0) ? 0U - d : d;
+    }
+    if ((d == 0) || (n < d))
+    {
+        return EMU_DIV_MIN_CYCLES;
+    }
+    uint32_t bits = (uint32_t)(__builtin_clz(d) - __builtin_clz(n));
+    uint32_t cycles = EMU_DIV_MIN_CYCLES + (bits + 3) / 4;
+    return (cycles > EMU_DIV_MAX_CYCLES) ? EMU_DIV_MAX_CYCLES : cycles;
+}
+
+
+// cycles for one instruction, not counting a taken branch's refill.
+// Cortex-M4 TRM table 3-1: LDR 2, LDM/STM/PUSH/POP 1+N, LDRD/STRD 3,
+// SDIV/UDIV 2-12, everything else in these kernels (including MUL,
+// the DSP multiplies, UMULL and UMAAL) 1.
+static uint32_t insnCycles(emuCpu *cpu, uint16_t hw1, uint16_t hw2, uint32_t size)
+{
+    if (size == 2)
+    {
+        if ((hw1 & 0xF800) == 0x4800)        // LDR literal
+        {
+            return 2;
+        }
+        if ((hw1 & 0xF000) == 0x5000)        // register offset
+        {
+            return (((hw1 >> 9) & 7) >= 3) ? 2 : 1;
+        }
+        if (((hw1 & 0xE000) == 0x6000) ||    // word/byte immediate
+            ((hw1 & 0xF000) == 0x8000) ||    // halfword immediate
+            ((hw1 & 0xF000) == 0x9000))      // SP relative
+        {
+            return (hw1 & 0x0800) ? 2 : 1;
+        }
+        if ((hw1 & 0xF000) == 0xC000)        // LDM/STM
+        {
+            return 1 + __builtin_popcount(hw1 & 0x00FF);
+        }
+        if ((hw1 & 0xF600) == 0xB400)        // PUSH/POP
+        {
+            return 1 + __builtin_popcount(hw1 & 0x01FF);
+        }
+        return 1;
+    }
+
+    if ((hw1 & 0xFE40) == 0xE800)            // LDM/STM/PUSH.W/POP.W
+    {
+        return 1 + __builtin_popcount(hw2 & 0xDFFF);
+    }
+    if ((hw1 & 0xFE40) == 0xE840)            // LDRD/STRD, exclusives, TBB
+    {
+        return (hw1 & 0x0120) ? 3 : 2;
+    }
+    if ((hw1 & 0xFE00) == 0xF800)            // LDR/STR (all sizes)
+    {
+        return (hw1 & 0x0010) ? 2 : 1;
+    }
+    if ((hw1 & 0xFFF0) == 0xFB90)
+    {
+        return divCycles(cpu->uc, hw1, hw2, true);
+    }
+    if ((hw1 & 0xFFF0) == 0xFBB0)
+    {
+        return divCycles(cpu->uc, hw1, hw2, false);
+    }
+    return 1;
+}
+
+
+static void codeHook(uc_engine *uc, uint64_t address, uint32_t size, void *user)
+{
+    emuCpu *cpu = user;
+    uint16_t hw[2] = { 0, 0 };
+    uint32_t addr = (uint32_t)address;
+
+    if ((addr >= EMU_FLASH_ADDR) && (addr - EMU_FLASH_ADDR + 4 <= EMU_FLASH_SIZE))
+    {
+        memcpy(hw, cpu->img->flash + (addr - EMU_FLASH_ADDR), size);
+    }
+    else
+    {
+        uc_mem_read(uc, address, hw, size);
+    }
+
+    if ((cpu->lastSize != 0) && (addr != cpu->lastAddr + cpu->lastSize))
+    {
+        cpu->cycles += EMU_BRANCH_REFILL;
+    }
+    if (cpu->coverage != NULL)
+    {
+        uint32_t edge = (cpu->lastAddr >> 1) * 0x9E3779B1U ^ (addr >> 1);
+        cpu->coverage[edge & (cpu->coverageLen - 1)]++;
+    }
+    cpu->insns++;
+    cpu->cycles += insnCycles(cpu, hw[0], hw[1], size);
+    cpu->lastAddr = addr;
+    cpu->lastSize = size;
+}
+
+
+static void uartHook(uc_engine *uc, uc_mem_type type, uint64_t address,
+        int size, int64_t value, void *user)
+{
+    emuCpu *cpu = user;
+
+    (void)uc;
+    (void)type;
+    (void)size;
+    if ((address == EMU_SERCOM5_ADDR + EMU_SERCOM_DATA) &&
+        (cpu->uartLen < EMU_UART_LEN - 1))
+    {
+        cpu->uart[cpu->uartLen++] = (char)value;
+        cpu->uart[cpu->uartLen] = '\0';
+    }
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+bool emuLoadElf(emuImage *img, const char *path)
+{
+    memset(img, 0, sizeof(*img));
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    img->elf = malloc(len);
+    img->flash = calloc(1, EMU_FLASH_SIZE);
+    img->sram = calloc(1, EMU_SRAM_SIZE);
+    bool ok = (img->elf != NULL) && (img->flash != NULL) && (img->sram != NULL) &&
+            (fread(img->elf, 1, len, f) == (size_t)len);
+    fclose(f);
+
+    const Elf32_Ehdr *eh = (const Elf32_Ehdr *)img->elf;
+    if (!ok || (len < (long)sizeof(*eh)) ||
+        (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) ||
+        (eh->e_ident[EI_CLASS] != ELFCLASS32) || (eh->e_machine != EM_ARM))
+    {
+        fprintf(stderr, "%s: not a 32 bit ARM ELF file\n", path);
+        emuFreeImage(img);
+        return false;
+    }
+
+    // segments: .text etc. at their flash address, and .data both at its
+    // flash (load) address and at its RAM address, as if startup ran
+    const Elf32_Phdr *ph = (const Elf32_Phdr *)(img->elf + eh->e_phoff);
+    uint32_t ramEnd = EMU_SRAM_ADDR;
+    for (uint32_t i = 0; i < eh->e_phnum; ++i)
+    {
+        if (ph[i].p_type != PT_LOAD)
+        {
+            continue;
+        }
+        const uint8_t *bytes = img->elf + ph[i].p_offset;
+        loadSegment(img, ph[i].p_paddr, bytes, ph[i].p_filesz);
+        if (ph[i].p_vaddr != ph[i].p_paddr)
+        {
+            loadSegment(img, ph[i].p_vaddr, bytes, ph[i].p_filesz);
+        }
+        uint32_t end = ph[i].p_vaddr + ph[i].p_memsz;
+        if ((ph[i].p_vaddr >= EMU_SRAM_ADDR) && (end > ramEnd))
+        {
+            ramEnd = end;
+        }
+    }
+    img->scratchAddr = (ramEnd + 15) & ~15UL;
+
+    // function and object symbols
+    const Elf32_Shdr *sh = (const Elf32_Shdr *)(img->elf + eh->e_shoff);
+    for (uint32_t i = 0; i < eh->e_shnum; ++i)
+    {
+        if (sh[i].sh_type != SHT_SYMTAB)
+        {
+            continue;
+        }
+        const Elf32_Sym *sym = (const Elf32_Sym *)(img->elf + sh[i].sh_offset);
+        const char *names = (const char *)(img->elf + sh[sh[i].sh_link].sh_offset);
+        uint32_t n = sh[i].sh_size / sizeof(Elf32_Sym);
+        img->syms = calloc(n, sizeof(emuSymbol));
+        for (uint32_t k = 0; (img->syms != NULL) && (k < n); ++k)
+        {
+            uint32_t type = ELF32_ST_TYPE(sym[k].st_info);
+            if ((sym[k].st_name != 0) && (sym[k].st_shndx != SHN_UNDEF) &&
+                ((type == STT_FUNC) || (type == STT_OBJECT)))
+            {
+                emuSymbol *s = &img->syms[img->numSyms++];
+                s->name = names + sym[k].st_name;
+                s->value = sym[k].st_value;
+                s->size = sym[k].st_size;
+                s->local = (ELF32_ST_BIND(sym[k].st_info) == STB_LOCAL);
+            }
+        }
+        break;
+    }
+    if (img->numSyms == 0)
+    {
+        fprintf(stderr, "%s: no symbol table (stripped?)\n", path);
+        emuFreeImage(img);
+        return false;
+    }
+    return true;
+}
+
+
+void emuFreeImage(emuImage *img)
+{
+    free(img->elf);
+    free(img->flash);
+    free(img->sram);
+    free(img->syms);
+    memset(img, 0, sizeof(*img));
+}
+
+
+uint32_t emuSymbolAddr(const emuImage *img, const char *name)
+{
+    // a global symbol wins over a static with the same name
+    uint32_t localAddr = 0;
+    for (uint32_t i = 0; i < img->numSyms; ++i)
+    {
+        if (strcmp(img->syms[i].name, name) != 0)
+        {
+            continue;
+        }
+        if (img->syms[i].local == false)
+        {
+            return img->syms[i].value;
+        }
+        if (localAddr == 0)
+        {
+            localAddr = img->syms[i].value;
+        }
+    }
+    return localAddr;
+}
+
+
+bool emuOpen(emuCpu *cpu, const emuImage *img, bool counting)
+{
+    uc_err err;
+    uc_hook hook;
+    const uint16_t bkpt = 0xBE00;
+    const uint8_t intflag = 0x03;   // DRE | TXC: always ready to send
+
+    memset(cpu, 0, sizeof(*cpu));
+    cpu->img = img;
+    cpu->counting = counting;
+    cpu->timeoutUs = 10 * 1000000ULL;
+
+    err = uc_open(UC_ARCH_ARM, UC_MODE_THUMB | UC_MODE_MCLASS, &cpu->uc);
+    if (err == UC_ERR_OK)
+    {
+        err = uc_ctl_set_cpu_model(cpu->uc, UC_CPU_ARM_CORTEX_M4);
+    }
+    if (err == UC_ERR_OK)
+    {
+        err = uc_mem_map(cpu->uc, EMU_FLASH_ADDR, EMU_FLASH_SIZE,
+                UC_PROT_READ | UC_PROT_EXEC);
+    }
+    if (err == UC_ERR_OK)
+    {
+        err = uc_mem_map(cpu->uc, EMU_SRAM_ADDR, EMU_SRAM_SIZE, UC_PROT_ALL);
+    }
+    if (err == UC_ERR_OK)
+    {
+        err = uc_mem_map(cpu->uc, EMU_RETURN_ADDR, 0x1000,
+                UC_PROT_READ | UC_PROT_EXEC);
+    }
+    if (err == UC_ERR_OK)
+    {
+        err = uc_mem_map(cpu->uc, EMU_SERCOM5_ADDR & ~0xFFFUL, 0x1000,
+                UC_PROT_READ | UC_PROT_WRITE);
+    }
+    if (err == UC_ERR_OK)
+    {
+        uc_mem_write(cpu->uc, EMU_FLASH_ADDR, img->flash, EMU_FLASH_SIZE);
+        uc_mem_write(cpu->uc, EMU_SRAM_ADDR, img->sram, EMU_SRAM_SIZE);
+        uc_mem_write(cpu->uc, EMU_RETURN_ADDR, &bkpt, sizeof(bkpt));
+        uc_mem_write(cpu->uc, EMU_SERCOM5_ADDR + EMU_SERCOM_INTFLAG,
+                &intflag, sizeof(intflag));
+        err = uc_hook_add(cpu->uc, &hook, UC_HOOK_MEM_WRITE, uartHook, cpu,
+                EMU_SERCOM5_ADDR + EMU_SERCOM_DATA,
+                EMU_SERCOM5_ADDR + EMU_SERCOM_DATA + 3);
+    }
+    if ((err == UC_ERR_OK) && counting)
+    {
+        err = uc_hook_add(cpu->uc, &hook, UC_HOOK_CODE, codeHook, cpu, 1, 0);
+    }
+    if (err != UC_ERR_OK)
+    {
+        fprintf(stderr, "emulator setup failed: %s\n", uc_strerror(err));
+        emuClose(cpu);
+        return false;
+    }
+    return true;
+}
+
+
+void emuClose(emuCpu *cpu)
+{
+    if (cpu->uc != NULL)
+    {
+        uc_close(cpu->uc);
+        cpu->uc = NULL;
+    }
+}
+
+
+bool emuCall(emuCpu *cpu, uint32_t func, const uint32_t *args,
+        uint32_t numArgs, uint32_t *r0, uint32_t *r1)
+{
+    uint32_t sp = EMU_SRAM_ADDR + EMU_SRAM_SIZE;
+    uint32_t lr = EMU_RETURN_ADDR | 1;
+    uint32_t pc = 0;
+
+    if ((func == 0) || (numArgs > EMU_MAX_ARGS))
+    {
+        return false;
+    }
+    // AAPCS: r0-r3, then the stack, 8 byte aligned at the call
+    if (numArgs > 4)
+    {
+        sp -= 4 * (numArgs - 4);
+        sp &= ~7UL;
+        emuWrite(cpu, sp, &args[4], 4 * (numArgs - 4));
+    }
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        uint32_t v = (i < numArgs) ? args[i] : 0;
+        uc_reg_write(cpu->uc, armRegs[i], &v);
+    }
+    uc_reg_write(cpu->uc, UC_ARM_REG_SP, &sp);
+    uc_reg_write(cpu->uc, UC_ARM_REG_LR, &lr);
+    cpu->callSp = sp;
+
+    cpu->insns = 0;
+    cpu->cycles = 0;
+    cpu->lastAddr = 0;
+    cpu->lastSize = 0;
+    uc_err err = uc_emu_start(cpu->uc, func | 1, EMU_RETURN_ADDR,
+            cpu->timeoutUs, 0);
+    uc_reg_read(cpu->uc, UC_ARM_REG_PC, &pc);
+    if ((err != UC_ERR_OK) || ((pc & ~1UL) != EMU_RETURN_ADDR))
+    {
+        fprintf(stderr, "call to 0x%08x stopped at 0x%08x: %s\n", func, pc,
+                (err != UC_ERR_OK) ? uc_strerror(err) : "timed out");
+        return false;
+    }
+    if (cpu->counting && (cpu->lastSize != 0))
+    {
+        cpu->cycles += EMU_BRANCH_REFILL;    // the return itself
+    }
+
+    *r0 = regRead(cpu->uc, 0);
+    if (r1 != NULL)
+    {
+        *r1 = regRead(cpu->uc, 1);
+    }
+    return true;
+}
+
+
+void emuSetReg(emuCpu *cpu, uint32_t n, uint32_t v)
+{
+    uc_reg_write(cpu->uc, armRegs[n & 15], &v);
+}
+
+
+uint32_t emuGetReg(emuCpu *cpu, uint32_t n)
+{
+    return regRead(cpu->uc, n);
+}
+
+
+bool emuWrite(emuCpu *cpu, uint32_t addr, const void *buf, size_t len)
+{
+    return uc_mem_write(cpu->uc, addr, buf, len) == UC_ERR_OK;
+}
+
+
+bool emuRead(emuCpu *cpu, uint32_t addr, void *buf, size_t len)
+{
+    return uc_mem_read(cpu->uc, addr, buf, len) == UC_ERR_OK;
+}
+
+
+uint32_t emuReadWord(emuCpu *cpu, uint32_t addr)
+{
+    uint32_t v = 0;
+    emuRead(cpu, addr, &v, sizeof(v));
+    return v;
+}
+
+
+void emuUartClear(emuCpu *cpu)
+{
+    cpu->uartLen = 0;
+    cpu->uart[0] = '\0';
+}
+
+/* *****************************************************************************
+ End of File
+ */
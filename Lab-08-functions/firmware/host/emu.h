@@ -0,0 +1,138 @@
+/* ************************************************************************** */
+/** Cortex-M4 emulator for the built firmware
+
+  @File Name
+    emu.h
+
+  @Summary
+    Loads the MPLAB ELF into a Unicorn engine and calls functions in it.
+
+  @Description
+    emuLoadElf reads the flash and RAM images and the symbol table once;
+    any number of emuCpu's can then be opened on the same image (one per
+    thread; the image is only read). emuCall runs one function from its
+    first instruction to its return, like a C call: r0-r3 and then the
+    stack for the arguments, r0/r1 for the result.
+
+    With counting on, every instruction is counted and given an estimated
+    Cortex-M4 cycle cost (TRM instruction timings, zero wait state memory
+    as if running from the CMCC cache, 2 cycle pipeline refill for every
+    taken branch). Counting slows the emulator down a lot, so the
+    verification runs leave it off.
+
+    CPU writes to the SERCOM5 DATA register are captured in uart[].
+    The DMAC is not modelled, so printAndWait output is not; the asm
+    kernels don't print anyway.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _EMU_H    /* Guard against multiple inclusion */
+#define _EMU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <unicorn/unicorn.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SAM E51 memory map, same as same51j20a.h
+#define EMU_FLASH_ADDR      0x00000000UL
+#define EMU_FLASH_SIZE      0x00100000UL
+#define EMU_SRAM_ADDR       0x20000000UL
+#define EMU_SRAM_SIZE       0x00040000UL
+#define EMU_SERCOM5_ADDR    0x43000400UL
+#define EMU_SERCOM_DATA     0x28    // USART_INT DATA offset
+#define EMU_SERCOM_INTFLAG  0x18    // reads as DRE | TXC
+
+// emuCall sets LR to this, and stops when the function returns to it.
+// Nothing on the SAM E51 lives at this address.
+#define EMU_RETURN_ADDR     0x10000000UL
+
+#define EMU_MAX_ARGS        8
+#define EMU_UART_LEN        1024
+
+typedef struct _emuSymbol
+{
+    const char *name;     // points into emuImage.elf
+    uint32_t value;       // Thumb functions have bit 0 set
+    uint32_t size;
+    bool local;           // static in C, or not .global in asm
+} emuSymbol;
+
+// what emuLoadElf read from the ELF. Read-only after loading.
+typedef struct _emuImage
+{
+    uint8_t *elf;         // the whole file
+    uint8_t *flash;       // EMU_FLASH_SIZE bytes, loaded segments by LMA
+    uint8_t *sram;        // EMU_SRAM_SIZE bytes, .data by VMA
+    emuSymbol *syms;
+    uint32_t numSyms;
+    uint32_t scratchAddr; // first free RAM word above .data/.bss
+} emuImage;
+
+typedef struct _emuCpu
+{
+    uc_engine *uc;
+    const emuImage *img;
+    bool counting;        // count instructions and cycles in emuCall
+    uint64_t timeoutUs;   // per emuCall, 0 for none
+    // counts for the last emuCall, when counting
+    uint64_t insns;
+    uint64_t cycles;
+    uint32_t lastAddr;    // previous instruction, to spot taken branches
+    uint32_t lastSize;
+    uint32_t callSp;      // SP at the last emuCall; it must come back the same
+    // optional edge coverage, when counting: coverage[hash of (previous
+    // instruction, this one) & (coverageLen - 1)] is incremented.
+    // coverageLen is a power of 2.
+    uint8_t *coverage;
+    uint32_t coverageLen;
+    // bytes written to SERCOM5 DATA since the last emuUartClear
+    char uart[EMU_UART_LEN];
+    uint32_t uartLen;
+} emuCpu;
+
+// read path into img. Prints the reason and returns false on failure.
+bool emuLoadElf(emuImage *img, const char *path);
+void emuFreeImage(emuImage *img);
+
+// address of a symbol, 0 if there isn't one. Thumb bit left as is.
+uint32_t emuSymbolAddr(const emuImage *img, const char *name);
+
+// new emulator with img's flash and RAM contents
+bool emuOpen(emuCpu *cpu, const emuImage *img, bool counting);
+void emuClose(emuCpu *cpu);
+
+// call func(args[0..numArgs)). The result is r0, and r1 for 64 bit
+// results (r1 can be NULL). Prints the reason and returns false if the
+// function faults, times out or doesn't return.
+bool emuCall(emuCpu *cpu, uint32_t func, const uint32_t *args,
+        uint32_t numArgs, uint32_t *r0, uint32_t *r1);
+
+// core registers r0-r15, e.g. to plant values in the callee-saved
+// registers before an emuCall and check them after
+void emuSetReg(emuCpu *cpu, uint32_t n, uint32_t v);
+uint32_t emuGetReg(emuCpu *cpu, uint32_t n);
+
+// target memory
+bool emuWrite(emuCpu *cpu, uint32_t addr, const void *buf, size_t len);
+bool emuRead(emuCpu *cpu, uint32_t addr, void *buf, size_t len);
+uint32_t emuReadWord(emuCpu *cpu, uint32_t addr);
+
+void emuUartClear(emuCpu *cpu);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EMU_H */
+
+/* *****************************************************************************
+ End of File
+ */
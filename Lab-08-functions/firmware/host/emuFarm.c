@@ -0,0 +1,512 @@
+/* ************************************************************************** */
+/** Multi-threaded verification of the whole packed input space
+
+  @File Name
+    emuFarm.c
+
+  @Summary
+    Runs asmMainBatch from the built ELF on all 2^32 packed values, split
+    across every core, and writes a mismatch report.
+
+  @Description
+    sweepPackedInputs does this on the board, but takes hours there.
+    Here each worker thread opens its own emulator (emu.h) on the same
+    loaded ELF and takes chunks of the input space from a shared counter
+    until there are none left, so faster threads just take more chunks
+    and the run scales with the number of cores. Counting is off, so the
+    emulator runs the kernel at full speed.
+
+      make emu
+      ./build/emuFarm [-j threads] [-k kernel] [-s start] [-n count]
+                      [-o report] [file.elf]
+
+    -k picks another kernel with the asmMainBatch arguments
+    (packedBatchFunc in testRunner.h). -s and -n check part of the space,
+    -o writes the report to a file instead of stdout. Each product is
+    checked against a[i] * b[i] as it comes back; a mismatch is reported
+    with the calcExpectedValues breakdown. Every call has a time limit;
+    when a batch doesn't return, its values are rerun one at a time and
+    each one that doesn't return either is a mismatch too. The exit status is 0 if every
+    value matched, 1 on mismatches and 2 if the run couldn't finish.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "emu.h"
+#include "testFuncs.h"
+
+#define DEFAULT_ELF \
+    "../Lab-08-func-starter.X/dist/default/production/Lab-08-func-starter.X.production.elf"
+
+// values a worker takes from the shared counter at a time
+#define FARM_CHUNK_VALS     (1UL << 20)
+
+// values per kernel call; in and out arrays both go in target RAM
+#define FARM_BLOCK_VALS     8192
+
+// mismatches kept for the report, per worker and in total: the ones
+// for the lowest packed values. The rest are only counted.
+#define FARM_MAX_REPORTED   1000
+
+// stack room left above the arrays
+#define FARM_STACK_BYTES    4096
+
+#define FARM_MAX_THREADS    256
+
+// time limits for one kernel call: a whole block, and one value when a
+// block didn't return. Both are far above what a working kernel needs.
+#define FARM_BLOCK_TIMEOUT_US   (2 * 1000000ULL)
+#define FARM_VALUE_TIMEOUT_US   (10 * 1000ULL)
+
+typedef struct _farmMismatch
+{
+    uint32_t packed;
+    int32_t got;
+    bool noReturn;            // the call hit its time limit or faulted
+} farmMismatch;
+
+// shared by all the workers
+typedef struct _farmJob
+{
+    const emuImage *img;
+    uint32_t func;
+    uint64_t start;           // first packed value
+    uint64_t count;           // values to check
+    uint64_t numChunks;
+    uint64_t nextChunk;       // taken with __atomic_fetch_add
+    uint64_t valsDone;        // for the progress line
+    uint64_t mismatches;      // including the noReturns
+    uint64_t noReturns;
+    atomic_bool failed;       // a worker couldn't go on; all of them stop
+} farmJob;
+
+typedef struct _farmWorker
+{
+    pthread_t thread;
+    farmJob *job;
+    uint64_t vals;
+    uint64_t mismatches;
+    uint64_t noReturns;
+    uint32_t numReported;
+    farmMismatch reported[FARM_MAX_REPORTED];
+} farmWorker;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static double secondsNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+
+// out[i] for each of packed[0..n), one call per value, after a call
+// for the whole block didn't return. stuck[i] is set for the values
+// whose own call doesn't return either.
+static void farmRunEach(emuCpu *cpu, const farmJob *job, uint32_t inAddr,
+        uint32_t outAddr, const uint32_t *packed, int32_t *out, bool *stuck,
+        uint32_t n)
+{
+    cpu->timeoutUs = FARM_VALUE_TIMEOUT_US;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t args[3] = { inAddr, outAddr, 1 };
+        uint32_t r0;
+        emuWrite(cpu, inAddr, &packed[i], sizeof(packed[i]));
+        stuck[i] = !emuCall(cpu, job->func, args, 3, &r0, NULL);
+        out[i] = 0;
+        if (!stuck[i])
+        {
+            emuRead(cpu, outAddr, &out[i], sizeof(out[i]));
+        }
+    }
+    cpu->timeoutUs = FARM_BLOCK_TIMEOUT_US;
+}
+
+
+static void *farmWorkerRun(void *arg)
+{
+    farmWorker *w = arg;
+    farmJob *job = w->job;
+    emuCpu cpu;
+    static __thread uint32_t packed[FARM_BLOCK_VALS];
+    static __thread int32_t out[FARM_BLOCK_VALS];
+    static __thread bool stuck[FARM_BLOCK_VALS];
+
+    if (!emuOpen(&cpu, job->img, false))
+    {
+        atomic_store(&job->failed, true);
+        return NULL;
+    }
+    cpu.timeoutUs = FARM_BLOCK_TIMEOUT_US;
+    uint32_t inAddr = job->img->scratchAddr;
+    uint32_t outAddr = inAddr + sizeof(packed);
+
+    while (!atomic_load(&job->failed))
+    {
+        uint64_t chunk = __atomic_fetch_add(&job->nextChunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= job->numChunks)
+        {
+            break;
+        }
+        uint64_t first = chunk * FARM_CHUNK_VALS;
+        uint64_t last = first + FARM_CHUNK_VALS;
+        if (last > job->count)
+        {
+            last = job->count;
+        }
+
+        for (uint64_t v = first; (v < last) && !atomic_load(&job->failed);
+                v += FARM_BLOCK_VALS)
+        {
+            uint32_t n = (last - v < FARM_BLOCK_VALS) ?
+                    (uint32_t)(last - v) : FARM_BLOCK_VALS;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                packed[i] = (uint32_t)(job->start + v + i);
+            }
+            emuWrite(&cpu, inAddr, packed, n * sizeof(packed[0]));
+            uint32_t args[3] = { inAddr, outAddr, n };
+            uint32_t r0;
+            if (emuCall(&cpu, job->func, args, 3, &r0, NULL))
+            {
+                emuRead(&cpu, outAddr, out, n * sizeof(out[0]));
+                memset(stuck, 0, n * sizeof(stuck[0]));
+            }
+            else
+            {
+                farmRunEach(&cpu, job, inAddr, outAddr, packed, out, stuck, n);
+            }
+
+            uint32_t bad = 0;
+            uint32_t noReturns = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                int32_t want = (int32_t)(int16_t)(packed[i] >> 16) * (int16_t)packed[i];
+                if (stuck[i] || (out[i] != want))
+                {
+                    ++bad;
+                    noReturns += stuck[i] ? 1 : 0;
+                    if (w->numReported < FARM_MAX_REPORTED)
+                    {
+                        w->reported[w->numReported].packed = packed[i];
+                        w->reported[w->numReported].got = out[i];
+                        w->reported[w->numReported].noReturn = stuck[i];
+                        ++w->numReported;
+                    }
+                }
+            }
+            w->vals += n;
+            w->mismatches += bad;
+            w->noReturns += noReturns;
+            __atomic_fetch_add(&job->valsDone, n, __ATOMIC_RELAXED);
+            if (bad != 0)
+            {
+                __atomic_fetch_add(&job->mismatches, bad, __ATOMIC_RELAXED);
+            }
+            // a kernel that hangs on this many values will take hours
+            // at FARM_VALUE_TIMEOUT_US each; stop the run instead
+            if (w->noReturns > FARM_MAX_REPORTED)
+            {
+                atomic_store(&job->failed, true);
+            }
+        }
+    }
+
+    emuClose(&cpu);
+    return NULL;
+}
+
+
+static int comparePacked(const void *a, const void *b)
+{
+    uint32_t x = ((const farmMismatch *)a)->packed;
+    uint32_t y = ((const farmMismatch *)b)->packed;
+    return (x > y) - (x < y);
+}
+
+
+static void writeReport(FILE *f, const char *path, const char *kernel,
+        const farmJob *job, uint32_t numThreads, double seconds,
+        farmMismatch *list, uint32_t numListed)
+{
+    expectedValues e;
+
+    fprintf(f,
+            "# emuFarm mismatch report\n"
+            "# elf:        %s\n"
+            "# kernel:     %s\n"
+            "# range:      0x%08llx..0x%08llx (%llu values, %llu checked)\n"
+            "# threads:    %u, %.1f s, %.0f values/sec\n"
+            "# mismatches: %llu (%llu didn't return)",
+            path, kernel,
+            (unsigned long long)job->start,
+            (unsigned long long)(job->start + job->count - 1),
+            (unsigned long long)job->count,
+            (unsigned long long)job->valsDone,
+            numThreads, seconds,
+            // from the values actually checked, so a run that stopped
+            // early doesn't report the rate of a full one
+            (seconds > 0) ? (double)job->valsDone / seconds : 0.0,
+            (unsigned long long)job->mismatches,
+            (unsigned long long)job->noReturns);
+    if (job->mismatches > numListed)
+    {
+        fprintf(f, " (%u listed)", numListed);
+    }
+    fprintf(f, "\n");
+    if (numListed == 0)
+    {
+        return;
+    }
+    fprintf(f, "# packed          a       b     returned     expected\n");
+    for (uint32_t i = 0; i < numListed; ++i)
+    {
+        calcExpectedValues(0, "", list[i].packed, &e);
+        if (list[i].noReturn)
+        {
+            fprintf(f, "0x%08x %7d %7d    no return %12d\n", list[i].packed,
+                    (int)e.inputA, (int)e.inputB, (int)e.finalProduct);
+            continue;
+        }
+        fprintf(f, "0x%08x %7d %7d %12d %12d\n", list[i].packed,
+                (int)e.inputA, (int)e.inputB, (int)list[i].got,
+                (int)e.finalProduct);
+    }
+}
+
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-j threads] [-k kernel] [-s start] [-n count]\n"
+            "          [-o report] [file.elf]\n"
+            "default file: %s\n", prog, DEFAULT_ELF);
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Main Entry Point                                                  */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+int main(int argc, char **argv)
+{
+    const char *path = DEFAULT_ELF;
+    const char *kernel = "asmMainBatch";
+    const char *reportPath = NULL;
+    long numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t start = 0;
+    uint64_t count = 1ULL << 32;
+    emuImage img;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = (i + 1 < argc);
+        if ((strcmp(argv[i], "-j") == 0) && hasValue)
+        {
+            numThreads = strtol(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-k") == 0) && hasValue)
+        {
+            kernel = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && hasValue)
+        {
+            start = strtoull(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && hasValue)
+        {
+            count = strtoull(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-o") == 0) && hasValue)
+        {
+            reportPath = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    if ((start >= (1ULL << 32)) || (count == 0))
+    {
+        fprintf(stderr, "nothing to check: start must be < 2^32 and count > 0\n");
+        return 2;
+    }
+    if (count > (1ULL << 32) - start)
+    {
+        count = (1ULL << 32) - start;
+    }
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+    if (numThreads > FARM_MAX_THREADS)
+    {
+        numThreads = FARM_MAX_THREADS;
+    }
+
+    if (!emuLoadElf(&img, path))
+    {
+        return 2;
+    }
+    uint32_t func = emuSymbolAddr(&img, kernel);
+    if (func == 0)
+    {
+        fprintf(stderr, "%s: no symbol %s\n", path, kernel);
+        emuFreeImage(&img);
+        return 2;
+    }
+    if (img.scratchAddr + 2 * FARM_BLOCK_VALS * sizeof(uint32_t) >
+        EMU_SRAM_ADDR + EMU_SRAM_SIZE - FARM_STACK_BYTES)
+    {
+        fprintf(stderr, "%s: not enough free RAM above .bss for the arrays\n", path);
+        emuFreeImage(&img);
+        return 2;
+    }
+
+    farmJob job = {
+        .img = &img,
+        .func = func,
+        .start = start,
+        .count = count,
+        .numChunks = (count + FARM_CHUNK_VALS - 1) / FARM_CHUNK_VALS,
+    };
+    atomic_init(&job.failed, false);
+    farmWorker *workers = calloc(numThreads, sizeof(farmWorker));
+    if (workers == NULL)
+    {
+        emuFreeImage(&img);
+        return 2;
+    }
+
+    fprintf(stderr, "%s: checking %llu values on %ld threads\n", kernel,
+            (unsigned long long)count, numThreads);
+    double t0 = secondsNow();
+    long started = 0;
+    for (; started < numThreads; ++started)
+    {
+        workers[started].job = &job;
+        if (pthread_create(&workers[started].thread, NULL, farmWorkerRun,
+                &workers[started]) != 0)
+        {
+            break;
+        }
+    }
+
+    // progress about once a second until every value is done or a call
+    // fails. Polls more often than that so a short run isn't held up.
+    const struct timespec poll = { 0, 50 * 1000000L };
+    uint64_t done = 0;
+    double lastProgress = t0;
+    while ((done < count) && !atomic_load(&job.failed) && (started > 0))
+    {
+        nanosleep(&poll, NULL);
+        done = __atomic_load_n(&job.valsDone, __ATOMIC_RELAXED);
+        double now = secondsNow();
+        if ((now - lastProgress < 1.0) && (done < count))
+        {
+            continue;
+        }
+        lastProgress = now;
+        double secs = now - t0;
+        fprintf(stderr, "\r%5.1f%%  %llu M values, %llu mismatches, %.0f M values/sec ",
+                100.0 * (double)done / (double)count,
+                (unsigned long long)(done >> 20),
+                (unsigned long long)__atomic_load_n(&job.mismatches, __ATOMIC_RELAXED),
+                (double)done / secs / 1e6);
+    }
+    fprintf(stderr, "\n");
+    for (long i = 0; i < started; ++i)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double seconds = secondsNow() - t0;
+
+    // gather what the workers kept, in packed value order. A worker
+    // takes its chunks in increasing order, so what it kept are its
+    // lowest mismatches, and the lowest FARM_MAX_REPORTED of the run
+    // are all in the union, whichever thread found them.
+    farmMismatch *list = calloc((size_t)started * FARM_MAX_REPORTED + 1,
+            sizeof(farmMismatch));
+    if (list == NULL)
+    {
+        fprintf(stderr, "%s: no memory to list the mismatches\n", kernel);
+    }
+    uint32_t numListed = 0;
+    uint64_t mismatches = 0;
+    for (long i = 0; i < started; ++i)
+    {
+        if (list != NULL)
+        {
+            memcpy(&list[numListed], workers[i].reported,
+                    workers[i].numReported * sizeof(list[0]));
+            numListed += workers[i].numReported;
+        }
+        mismatches += workers[i].mismatches;
+        job.noReturns += workers[i].noReturns;
+    }
+    job.mismatches = mismatches;
+    if (numListed != 0)
+    {
+        qsort(list, numListed, sizeof(list[0]), comparePacked);
+    }
+    if (numListed > FARM_MAX_REPORTED)
+    {
+        numListed = FARM_MAX_REPORTED;
+    }
+
+    int status = 0;
+    if (atomic_load(&job.failed) || (started < numThreads) || (job.valsDone != count))
+    {
+        fprintf(stderr, "%s: run did not finish\n", kernel);
+        status = 2;
+    }
+    else if (mismatches != 0)
+    {
+        status = 1;
+    }
+
+    FILE *f = stdout;
+    if ((reportPath != NULL) && ((f = fopen(reportPath, "w")) == NULL))
+    {
+        perror(reportPath);
+        f = stdout;
+    }
+    writeReport(f, path, kernel, &job, (uint32_t)started, seconds, list, numListed);
+    if (f != stdout)
+    {
+        fclose(f);
+    }
+
+    free(list);
+    free(workers);
+    emuFreeImage(&img);
+    return status;
+}
+
+/* *****************************************************************************
+ End of File
+ */
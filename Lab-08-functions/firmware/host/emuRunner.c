@@ -0,0 +1,625 @@
+/* ************************************************************************** */
+/** Emulator runner for the asmMult.s kernels
+
+  @File Name
+    emuRunner.c
+
+  @Summary
+    Calls each asmMult.s entry point in the built ELF with the tc[]
+    vectors, checks the results, and reports instructions and cycles.
+
+  @Description
+    The MPLAB simulator can't do the UART (see USING_HW in main.c), so
+    this gets numbers off every build without a board:
+
+      make emu
+      ./build/emuRunner [-v] [-k kernel] [file.elf]
+
+    The default ELF is the one MPLAB builds for the default
+    configuration. Each entry point is called through emu.c with the
+    same inputs the board tests use, and checked against
+    calcExpectedValues and the other testFuncs.c reference models.
+    -v prints every call; -k runs one kernel. Cycle counts are the
+    estimates described in emu.h, per call, from the kernel's first
+    instruction to its return. The exit status is the number of kernels
+    with mismatches or calls that didn't return.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "emu.h"
+#include "testFuncs.h"
+#include "testVectors.h"
+
+#define DEFAULT_ELF \
+    "../Lab-08-func-starter.X/dist/default/production/Lab-08-func-starter.X.production.elf"
+
+// longest array the batch kernels are called with
+#define MAX_BATCH_VALS  64
+
+// instruction and cycle counts for one kernel
+typedef struct _emuStats
+{
+    uint32_t calls;
+    uint32_t failedCalls;     // faulted or didn't return
+    uint32_t mismatches;
+    uint64_t minInsns;
+    uint64_t maxInsns;
+    uint64_t totalInsns;
+    uint64_t minCycles;
+    uint64_t maxCycles;
+    uint64_t totalCycles;
+} emuStats;
+
+// one kernel run: the emulator, where its buffers go, and its totals
+typedef struct _emuRun
+{
+    emuCpu *cpu;
+    const char *name;
+    uint32_t func;
+    uint32_t scratch;         // free target RAM for pointer arguments
+    emuStats stats;
+    bool verbose;
+} emuRun;
+
+// calls the kernel for e[0..n); returns false on any mismatch.
+// Per-value kernels get one value at a time, batch kernels all of them.
+typedef bool (*emuDriver)(emuRun *run, const expectedValues *e, uint32_t n);
+
+typedef struct _emuKernel
+{
+    const char *name;         // also the symbol in the ELF
+    emuDriver drive;
+    bool batch;
+} emuKernel;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// call the kernel and add the counts to run->stats
+static bool call(emuRun *run, const uint32_t *args, uint32_t numArgs,
+        uint32_t *r0, uint32_t *r1)
+{
+    emuCpu *cpu = run->cpu;
+    emuStats *s = &run->stats;
+
+    ++s->calls;
+    emuUartClear(cpu);
+    if (emuCall(cpu, run->func, args, numArgs, r0, r1) == false)
+    {
+        ++s->failedCalls;
+        return false;
+    }
+    // the first call that returned sets the minimums, even if an
+    // earlier one faulted
+    bool first = (s->calls - s->failedCalls == 1);
+    if (first || (cpu->insns < s->minInsns))
+    {
+        s->minInsns = cpu->insns;
+    }
+    if (first || (cpu->cycles < s->minCycles))
+    {
+        s->minCycles = cpu->cycles;
+    }
+    if (cpu->insns > s->maxInsns)
+    {
+        s->maxInsns = cpu->insns;
+    }
+    if (cpu->cycles > s->maxCycles)
+    {
+        s->maxCycles = cpu->cycles;
+    }
+    s->totalInsns += cpu->insns;
+    s->totalCycles += cpu->cycles;
+
+    if (run->verbose)
+    {
+        printf("  %-16s", run->name);
+        for (uint32_t i = 0; i < numArgs; ++i)
+        {
+            printf(" 0x%08x", args[i]);
+        }
+        printf(" -> 0x%08x  %4llu insns %4llu cycles\n", *r0,
+                (unsigned long long)cpu->insns, (unsigned long long)cpu->cycles);
+    }
+    if (cpu->uartLen != 0)
+    {
+        printf("  %s uart: %s\n", run->name, cpu->uart);
+    }
+    return true;
+}
+
+
+static bool mismatch(emuRun *run, uint32_t input, const char *what,
+        int64_t got, int64_t want)
+{
+    ++run->stats.mismatches;
+    printf("  %s(0x%08x): %s is %lld, expected %lld\n", run->name, input,
+            what, (long long)got, (long long)want);
+    return false;
+}
+
+
+static bool driveUnpack(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t args[3] = { e->packedVal, run->scratch, run->scratch + 4 };
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 3, &r0, NULL))
+    {
+        return false;
+    }
+    int32_t a = (int32_t)emuReadWord(run->cpu, run->scratch);
+    int32_t b = (int32_t)emuReadWord(run->cpu, run->scratch + 4);
+    if (a != e->inputA)
+    {
+        return mismatch(run, e->packedVal, "a", a, e->inputA);
+    }
+    if (b != e->inputB)
+    {
+        return mismatch(run, e->packedVal, "b", b, e->inputB);
+    }
+    return true;
+}
+
+
+static bool driveAbs(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    const int32_t in[2] = { e->inputA, e->inputB };
+    const int32_t absWant[2] = { e->absA, e->absB };
+    const int32_t signWant[2] = { e->signA, e->signB };
+    bool ok = true;
+
+    (void)n;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        uint32_t args[3] = { (uint32_t)in[i], run->scratch, run->scratch + 4 };
+        uint32_t r0;
+        if (!call(run, args, 3, &r0, NULL))
+        {
+            return false;
+        }
+        int32_t absVal = (int32_t)emuReadWord(run->cpu, run->scratch);
+        int32_t sign = (int32_t)emuReadWord(run->cpu, run->scratch + 4);
+        if (((int32_t)r0 != absWant[i]) || (absVal != absWant[i]))
+        {
+            ok = mismatch(run, args[0], "abs", (int32_t)r0, absWant[i]);
+        }
+        else if (sign != signWant[i])
+        {
+            ok = mismatch(run, args[0], "sign", sign, signWant[i]);
+        }
+    }
+    return ok;
+}
+
+
+static bool driveAbsPacked(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t args[3] = { e->packedVal, run->scratch, run->scratch + 4 };
+    uint32_t want = ((uint32_t)e->absA << 16) | ((uint32_t)e->absB & 0xFFFF);
+    uint32_t signWant = ((uint32_t)e->signA << 1) | (uint32_t)e->signB;
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 3, &r0, NULL))
+    {
+        return false;
+    }
+    if ((r0 != want) || (emuReadWord(run->cpu, run->scratch) != want))
+    {
+        return mismatch(run, e->packedVal, "packed abs", r0, want);
+    }
+    uint32_t signBits = emuReadWord(run->cpu, run->scratch + 4);
+    if (signBits != signWant)
+    {
+        return mismatch(run, e->packedVal, "sign bits", signBits, signWant);
+    }
+    return true;
+}
+
+
+// asmMult and its variants
+static bool driveMult(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t args[2] = { (uint32_t)e->absA, (uint32_t)e->absB };
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 2, &r0, NULL))
+    {
+        return false;
+    }
+    if ((int32_t)r0 != e->initProduct)
+    {
+        return mismatch(run, e->packedVal, "product", (int32_t)r0, e->initProduct);
+    }
+    return true;
+}
+
+
+static bool driveFixSign(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t args[3] = { (uint32_t)e->initProduct, (uint32_t)e->signA,
+            (uint32_t)e->signB };
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 3, &r0, NULL))
+    {
+        return false;
+    }
+    if ((int32_t)r0 != e->finalProduct)
+    {
+        return mismatch(run, e->packedVal, "product", (int32_t)r0, e->finalProduct);
+    }
+    return true;
+}
+
+
+static bool driveMain(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    static const char *globals[8] = {
+        "a_Multiplicand", "b_Multiplier", "a_Sign", "b_Sign",
+        "a_Abs", "b_Abs", "init_Product", "final_Product",
+    };
+    const int32_t want[8] = {
+        e->inputA, e->inputB, e->signA, e->signB,
+        e->absA, e->absB, e->initProduct, e->finalProduct,
+    };
+    uint32_t args[1] = { e->packedVal };
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 1, &r0, NULL))
+    {
+        return false;
+    }
+    if ((int32_t)r0 != e->finalProduct)
+    {
+        return mismatch(run, e->packedVal, "product", (int32_t)r0, e->finalProduct);
+    }
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        uint32_t addr = emuSymbolAddr(run->cpu->img, globals[i]);
+        int32_t got = (int32_t)emuReadWord(run->cpu, addr);
+        if ((addr != 0) && (got != want[i]))
+        {
+            return mismatch(run, e->packedVal, globals[i], got, want[i]);
+        }
+    }
+    return true;
+}
+
+
+static bool driveMainCtx(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    // mult_ctx_t field order (asmExterns.h)
+    const int32_t want[8] = {
+        e->inputA, e->inputB, e->signA, e->signB,
+        e->absA, e->absB, e->initProduct, e->finalProduct,
+    };
+    uint32_t args[2] = { e->packedVal, run->scratch };
+    int32_t ctx[8];
+    uint32_t r0;
+
+    (void)n;
+    if (!call(run, args, 2, &r0, NULL))
+    {
+        return false;
+    }
+    if ((int32_t)r0 != e->finalProduct)
+    {
+        return mismatch(run, e->packedVal, "product", (int32_t)r0, e->finalProduct);
+    }
+    emuRead(run->cpu, run->scratch, ctx, sizeof(ctx));
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        if (ctx[i] != want[i])
+        {
+            return mismatch(run, e->packedVal, "ctx field", ctx[i], want[i]);
+        }
+    }
+    return true;
+}
+
+
+static bool driveMainSat(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t args[1] = { e->packedVal };
+    uint32_t r0;
+
+    (void)n;
+    // without the symbol, address 0 would be read as the result
+    uint32_t rngErrorAddr = emuSymbolAddr(run->cpu->img, "rng_Error");
+    if (rngErrorAddr == 0)
+    {
+        ++run->stats.mismatches;
+        printf("  %s: no symbol rng_Error in the ELF, can't check it\n", run->name);
+        return false;
+    }
+    if (!call(run, args, 1, &r0, NULL))
+    {
+        return false;
+    }
+    int32_t rngError = (int32_t)emuReadWord(run->cpu, rngErrorAddr);
+    if ((int32_t)r0 != e->satProduct)
+    {
+        return mismatch(run, e->packedVal, "product", (int32_t)r0, e->satProduct);
+    }
+    if (rngError != e->rngError)
+    {
+        return mismatch(run, e->packedVal, "rng_Error", rngError, e->rngError);
+    }
+    return true;
+}
+
+
+static bool driveMainBatch(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t packed[MAX_BATCH_VALS];
+    int32_t out[MAX_BATCH_VALS];
+    uint32_t outAddr = run->scratch + sizeof(packed);
+    bool ok = true;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        packed[i] = e[i].packedVal;
+    }
+    emuWrite(run->cpu, run->scratch, packed, n * sizeof(packed[0]));
+    uint32_t args[3] = { run->scratch, outAddr, n };
+    uint32_t r0;
+    if (!call(run, args, 3, &r0, NULL))
+    {
+        return false;
+    }
+    emuRead(run->cpu, outAddr, out, n * sizeof(out[0]));
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (out[i] != e[i].finalProduct)
+        {
+            ok = mismatch(run, packed[i], "product", out[i], e[i].finalProduct);
+        }
+    }
+    return ok;
+}
+
+
+// asmDot16(x, y, n) and asmMac16(acc, x, y, n), with x = the vectors
+// and y = the vectors reversed
+static bool driveDot(emuRun *run, const expectedValues *e, uint32_t n,
+        bool mac)
+{
+    uint32_t x[MAX_BATCH_VALS];
+    uint32_t y[MAX_BATCH_VALS];
+    uint32_t xAddr = run->scratch;
+    uint32_t yAddr = run->scratch + sizeof(x);
+    const int64_t acc = -123456789;
+    uint32_t r0;
+    uint32_t r1;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        x[i] = e[i].packedVal;
+        y[i] = e[n - 1 - i].packedVal;
+    }
+    emuWrite(run->cpu, xAddr, x, n * sizeof(x[0]));
+    emuWrite(run->cpu, yAddr, y, n * sizeof(y[0]));
+    int64_t want = calcExpectedDot16(mac ? acc : 0, x, y, n);
+
+    bool called;
+    if (mac)
+    {
+        uint32_t args[5] = { (uint32_t)acc, (uint32_t)((uint64_t)acc >> 32),
+                xAddr, yAddr, n };
+        called = call(run, args, 5, &r0, &r1);
+    }
+    else
+    {
+        uint32_t args[3] = { xAddr, yAddr, n };
+        called = call(run, args, 3, &r0, &r1);
+    }
+    if (!called)
+    {
+        return false;
+    }
+    int64_t got = (int64_t)(((uint64_t)r1 << 32) | r0);
+    if (got != want)
+    {
+        return mismatch(run, n, "sum", got, want);
+    }
+    return true;
+}
+
+
+static bool driveDot16(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    return driveDot(run, e, n, false);
+}
+
+
+static bool driveMac16(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    return driveDot(run, e, n, true);
+}
+
+
+// asmMultN on the vectors as one n word number times the same number
+// reversed, for every n up to the number of vectors
+static bool driveMultN(emuRun *run, const expectedValues *e, uint32_t n)
+{
+    uint32_t a[MAX_BATCH_VALS];
+    uint32_t b[MAX_BATCH_VALS];
+    uint32_t r[2 * MAX_BATCH_VALS];
+    uint32_t want[2 * MAX_BATCH_VALS];
+    uint32_t rAddr = run->scratch;
+    uint32_t aAddr = rAddr + sizeof(r);
+    uint32_t bAddr = aAddr + sizeof(a);
+    bool ok = true;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        a[i] = e[i].packedVal;
+        b[i] = e[n - 1 - i].packedVal;
+    }
+    for (uint32_t limbs = 1; limbs <= n; ++limbs)
+    {
+        uint32_t args[4] = { rAddr, aAddr, bAddr, limbs };
+        uint32_t r0;
+        emuWrite(run->cpu, aAddr, a, limbs * sizeof(a[0]));
+        emuWrite(run->cpu, bAddr, b, limbs * sizeof(b[0]));
+        if (!call(run, args, 4, &r0, NULL))
+        {
+            return false;
+        }
+        emuRead(run->cpu, rAddr, r, 2 * limbs * sizeof(r[0]));
+        calcExpectedMultN(want, a, b, limbs);
+        if (memcmp(r, want, 2 * limbs * sizeof(r[0])) != 0)
+        {
+            ok = mismatch(run, limbs, "product words", 0, 0);
+        }
+    }
+    return ok;
+}
+
+
+static const emuKernel kernels[] = {
+    { "asmUnpack",       driveUnpack,    false },
+    { "asmAbs",          driveAbs,       false },
+    { "asmAbsPacked",    driveAbsPacked, false },
+    { "asmMult",         driveMult,      false },
+    { "asmMultShiftAdd", driveMult,      false },
+    { "asmMultHw",       driveMult,      false },
+    { "asmMultClz",      driveMult,      false },
+    { "asmFixSign",      driveFixSign,   false },
+    { "asmMain",         driveMain,      false },
+    { "asmMainCtx",      driveMainCtx,   false },
+    { "asmMainSat",      driveMainSat,   false },
+    { "asmMainBatch",    driveMainBatch, true },
+    { "asmDot16",        driveDot16,     true },
+    { "asmMac16",        driveMac16,     true },
+    { "asmMultN",        driveMultN,     true },
+};
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-v] [-k kernel] [file.elf]\n"
+            "default file: %s\n", prog, DEFAULT_ELF);
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Main Entry Point                                                  */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+int main(int argc, char **argv)
+{
+    const char *path = DEFAULT_ELF;
+    const char *only = NULL;
+    bool verbose = false;
+    emuImage img;
+    emuCpu cpu;
+    expectedValues expected[NUM_TEST_CASES];
+    int badKernels = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+        }
+        else if ((strcmp(argv[i], "-k") == 0) && (i + 1 < argc))
+        {
+            only = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (!emuLoadElf(&img, path) || !emuOpen(&cpu, &img, true))
+    {
+        return 1;
+    }
+    calcExpectedValuesN(tc, NUM_TEST_CASES, expected);
+
+    printf("%s\n"
+            "kernel           calls   insns/call: min    avg    max"
+            "   cycles/call: min    avg    max  result\n", path);
+    for (uint32_t k = 0; k < NUM_KERNELS; ++k)
+    {
+        const emuKernel *kt = &kernels[k];
+        if ((only != NULL) && (strcmp(only, kt->name) != 0))
+        {
+            continue;
+        }
+        emuRun run = {
+            .cpu = &cpu,
+            .name = kt->name,
+            .func = emuSymbolAddr(&img, kt->name),
+            .scratch = img.scratchAddr,
+            .verbose = verbose,
+        };
+        if (run.func == 0)
+        {
+            printf("%-16s not in the ELF, skipped\n", kt->name);
+            continue;
+        }
+        if (kt->batch)
+        {
+            kt->drive(&run, expected, NUM_TEST_CASES);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < NUM_TEST_CASES; ++i)
+            {
+                kt->drive(&run, &expected[i], 1);
+            }
+        }
+
+        const emuStats *s = &run.stats;
+        uint32_t good = s->calls - s->failedCalls;
+        bool pass = (s->mismatches == 0) && (s->failedCalls == 0);
+        printf("%-16s %5u %17llu %6llu %6llu %17llu %6llu %6llu  %s\n",
+                kt->name, s->calls,
+                (unsigned long long)s->minInsns,
+                (unsigned long long)(good ? s->totalInsns / good : 0),
+                (unsigned long long)s->maxInsns,
+                (unsigned long long)s->minCycles,
+                (unsigned long long)(good ? s->totalCycles / good : 0),
+                (unsigned long long)s->maxCycles,
+                pass ? "PASS" : "FAIL");
+        if (!pass)
+        {
+            ++badKernels;
+        }
+    }
+
+    emuClose(&cpu);
+    emuFreeImage(&img);
+    return badKernels;
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,471 @@
+/* ************************************************************************** */
+/** Differential fuzzer for the asmMult.s kernels
+
+  @File Name
+    fuzzEmu.c
+
+  @Summary
+    libFuzzer target that runs every asmMult.s entry point from the built
+    ELF in the emulator and compares it with the testFuncs.c references.
+
+  @Description
+    An input is a list of little-endian 32 bit words (at most
+    FUZZ_MAX_WORDS; a trailing partial word is ignored). Every
+    per-value kernel is called on every word as a packed value, and the
+    array kernels (asmMainBatch, asmDot16, asmMac16, asmMultN) on the
+    whole list. For each call the fuzzer checks:
+      - the returned value(s)
+      - memory: the scratch area and the asmMult.s globals must hold
+        exactly what the kernel is meant to store, and nothing else
+        may change
+      - r4-r11 and SP are the same after the call as before (AAPCS)
+    The first difference is printed and the fuzzer aborts, so libFuzzer
+    saves the input.
+
+    The emulator's edge coverage goes into libFuzzer's extra counters,
+    so the fuzzer is guided by the paths taken through the asm, not
+    just through this file.
+
+      make fuzz          clang + libFuzzer: ./build/fuzzEmu fuzzCorpus
+      make fuzz-replay   any cc: run every file in fuzzCorpus once
+
+    fuzzCorpus holds the seed inputs: each tc[] vector from main.c on
+    its own, all of them as one list, the +/-32768 and +/-1 edges, and
+    FUZZ_MAX_WORDS words of all ones (asmMultN's longest carry chains).
+    "make fuzz-run" fuzzes for FUZZ_SECONDS from these seeds. FUZZ_ELF in the environment
+    picks another ELF than the default MPLAB build.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "emu.h"
+#include "testFuncs.h"
+
+#define DEFAULT_ELF \
+    "../Lab-08-func-starter.X/dist/default/production/Lab-08-func-starter.X.production.elf"
+
+// longest input, in words; also the largest n for the array kernels
+#define FUZZ_MAX_WORDS      64
+
+// scratch area for pointer arguments, filled with FUZZ_FILL before
+// each call. asmMultN needs 4n words.
+#define FUZZ_SCRATCH_WORDS  (4 * FUZZ_MAX_WORDS)
+#define FUZZ_FILL           0xA5A5A5A5U
+
+// planted in r4-r11 before each call: 0xC0DE0004 .. 0xC0DE000B
+#define FUZZ_CANARY         0xC0DE0000U
+
+// the asmMult.s globals, in asmExterns.h order
+enum {
+    G_A_MULTIPLICAND, G_B_MULTIPLIER, G_RNG_ERROR, G_A_SIGN, G_B_SIGN,
+    G_PROD_IS_NEG, G_A_ABS, G_B_ABS, G_INIT_PRODUCT, G_FINAL_PRODUCT,
+    NUM_GLOBALS
+};
+static const char *globalNames[NUM_GLOBALS] = {
+    "a_Multiplicand", "b_Multiplier", "rng_Error", "a_Sign", "b_Sign",
+    "prod_Is_Neg", "a_Abs", "b_Abs", "init_Product", "final_Product",
+};
+
+// libFuzzer adds these to its own coverage counters
+__attribute__((used, section("__libfuzzer_extra_counters")))
+static uint8_t emuCoverage[1 << 12];
+
+static emuImage img;
+static emuCpu cpu;
+static uint32_t scratch;                      // target address
+static uint32_t scratchWant[FUZZ_SCRATCH_WORDS];
+static uint32_t globalAddr[NUM_GLOBALS];
+static int32_t globalWant[NUM_GLOBALS];
+
+// the kernel being checked, for the failure message
+static const char *curName;
+static uint32_t curInput;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static void fail(const char *what, int64_t got, int64_t want)
+{
+    fprintf(stderr, "FUZZ MISMATCH %s(0x%08x): %s is %lld (0x%llx), expected %lld (0x%llx)\n",
+            curName, curInput, what,
+            (long long)got, (unsigned long long)got,
+            (long long)want, (unsigned long long)want);
+    abort();
+}
+
+
+static void fuzzInit(void)
+{
+    const char *path = getenv("FUZZ_ELF");
+
+    if (path == NULL)
+    {
+        path = DEFAULT_ELF;
+    }
+    if (!emuLoadElf(&img, path) || !emuOpen(&cpu, &img, true))
+    {
+        exit(1);
+    }
+    cpu.coverage = emuCoverage;
+    cpu.coverageLen = sizeof(emuCoverage);
+    scratch = img.scratchAddr;
+    for (uint32_t i = 0; i < NUM_GLOBALS; ++i)
+    {
+        globalAddr[i] = emuSymbolAddr(&img, globalNames[i]);
+        if (globalAddr[i] == 0)
+        {
+            fprintf(stderr, "%s: no symbol %s\n", path, globalNames[i]);
+            exit(1);
+        }
+    }
+}
+
+
+// start a call: fill the scratch area, and expect it and the globals
+// to stay as they are unless the caller says otherwise
+static void begin(const char *name, uint32_t input)
+{
+    curName = name;
+    curInput = input;
+    for (uint32_t i = 0; i < FUZZ_SCRATCH_WORDS; ++i)
+    {
+        scratchWant[i] = FUZZ_FILL;
+    }
+    emuWrite(&cpu, scratch, scratchWant, sizeof(scratchWant));
+    for (uint32_t i = 0; i < NUM_GLOBALS; ++i)
+    {
+        globalWant[i] = (int32_t)emuReadWord(&cpu, globalAddr[i]);
+    }
+}
+
+
+// put an input array in the scratch area, at word offset
+static void input(uint32_t offset, const uint32_t *w, uint32_t n)
+{
+    memcpy(&scratchWant[offset], w, n * sizeof(w[0]));
+    emuWrite(&cpu, scratch + 4 * offset, w, n * sizeof(w[0]));
+}
+
+
+// call func, check the registers it must preserve, and return r0 (and
+// r1 in *r1 if r1 isn't NULL)
+static uint32_t call(uint32_t func, const uint32_t *args, uint32_t numArgs,
+        uint32_t *r1)
+{
+    uint32_t r0 = 0;
+
+    for (uint32_t r = 4; r <= 11; ++r)
+    {
+        emuSetReg(&cpu, r, FUZZ_CANARY | r);
+    }
+    if (!emuCall(&cpu, func, args, numArgs, &r0, r1))
+    {
+        fail("call (faulted or didn't return)", 0, 0);
+    }
+    for (uint32_t r = 4; r <= 11; ++r)
+    {
+        uint32_t v = emuGetReg(&cpu, r);
+        if (v != (FUZZ_CANARY | r))
+        {
+            char what[8];
+            snprintf(what, sizeof(what), "r%u", r);
+            fail(what, v, FUZZ_CANARY | r);
+        }
+    }
+    uint32_t sp = emuGetReg(&cpu, 13);
+    if (sp != cpu.callSp)
+    {
+        fail("SP", sp, cpu.callSp);
+    }
+    return r0;
+}
+
+
+// end a call: everything in memory must be as expected
+static void end(void)
+{
+    static uint32_t got[FUZZ_SCRATCH_WORDS];
+
+    emuRead(&cpu, scratch, got, sizeof(got));
+    for (uint32_t i = 0; i < FUZZ_SCRATCH_WORDS; ++i)
+    {
+        if (got[i] != scratchWant[i])
+        {
+            char what[32];
+            snprintf(what, sizeof(what), "scratch word %u", i);
+            fail(what, got[i], scratchWant[i]);
+        }
+    }
+    for (uint32_t i = 0; i < NUM_GLOBALS; ++i)
+    {
+        int32_t v = (int32_t)emuReadWord(&cpu, globalAddr[i]);
+        if (v != globalWant[i])
+        {
+            fail(globalNames[i], v, globalWant[i]);
+        }
+    }
+}
+
+
+static void checkR0(uint32_t r0, int32_t want)
+{
+    if ((int32_t)r0 != want)
+    {
+        fail("r0", (int32_t)r0, want);
+    }
+}
+
+
+// the kernels that take one packed value (or its parts)
+static void fuzzValue(uint32_t p)
+{
+    expectedValues e;
+    uint32_t f;
+
+    calcExpectedValues(0, "", p, &e);
+
+    if ((f = emuSymbolAddr(&img, "asmUnpack")) != 0)
+    {
+        begin("asmUnpack", p);
+        call(f, (uint32_t[]){ p, scratch, scratch + 4 }, 3, NULL);
+        scratchWant[0] = e.inputA;
+        scratchWant[1] = e.inputB;
+        end();
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmAbs")) != 0)
+    {
+        const int32_t in[2] = { e.inputA, e.inputB };
+        const int32_t absVal[2] = { e.absA, e.absB };
+        const int32_t sign[2] = { e.signA, e.signB };
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            begin("asmAbs", (uint32_t)in[i]);
+            checkR0(call(f, (uint32_t[]){ in[i], scratch, scratch + 4 }, 3, NULL),
+                    absVal[i]);
+            scratchWant[0] = absVal[i];
+            scratchWant[1] = sign[i];
+            end();
+        }
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmAbsPacked")) != 0)
+    {
+        uint32_t want = ((uint32_t)e.absA << 16) | ((uint32_t)e.absB & 0xFFFF);
+        begin("asmAbsPacked", p);
+        checkR0(call(f, (uint32_t[]){ p, scratch, scratch + 4 }, 3, NULL), want);
+        scratchWant[0] = want;
+        scratchWant[1] = ((uint32_t)e.signA << 1) | (uint32_t)e.signB;
+        end();
+    }
+
+    static const char *mults[] = {
+        "asmMult", "asmMultShiftAdd", "asmMultHw", "asmMultClz",
+    };
+    for (uint32_t i = 0; i < sizeof(mults) / sizeof(mults[0]); ++i)
+    {
+        if ((f = emuSymbolAddr(&img, mults[i])) != 0)
+        {
+            begin(mults[i], p);
+            checkR0(call(f, (uint32_t[]){ e.absA, e.absB }, 2, NULL), e.initProduct);
+            end();
+        }
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmFixSign")) != 0)
+    {
+        begin("asmFixSign", p);
+        checkR0(call(f, (uint32_t[]){ e.initProduct, e.signA, e.signB }, 3, NULL),
+                e.finalProduct);
+        end();
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmMain")) != 0)
+    {
+        begin("asmMain", p);
+        checkR0(call(f, (uint32_t[]){ p }, 1, NULL), e.finalProduct);
+        globalWant[G_A_MULTIPLICAND] = e.inputA;
+        globalWant[G_B_MULTIPLIER] = e.inputB;
+        globalWant[G_A_SIGN] = e.signA;
+        globalWant[G_B_SIGN] = e.signB;
+        globalWant[G_A_ABS] = e.absA;
+        globalWant[G_B_ABS] = e.absB;
+        globalWant[G_INIT_PRODUCT] = e.initProduct;
+        globalWant[G_FINAL_PRODUCT] = e.finalProduct;
+        end();
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmMainCtx")) != 0)
+    {
+        // mult_ctx_t field order (asmExterns.h)
+        const int32_t ctx[8] = {
+            e.inputA, e.inputB, e.signA, e.signB,
+            e.absA, e.absB, e.initProduct, e.finalProduct,
+        };
+        begin("asmMainCtx", p);
+        checkR0(call(f, (uint32_t[]){ p, scratch }, 2, NULL), e.finalProduct);
+        memcpy(scratchWant, ctx, sizeof(ctx));
+        end();
+
+        begin("asmMainCtx(NULL)", p);
+        checkR0(call(f, (uint32_t[]){ p, 0 }, 2, NULL), e.finalProduct);
+        end();
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmMainSat")) != 0)
+    {
+        begin("asmMainSat", p);
+        checkR0(call(f, (uint32_t[]){ p }, 1, NULL), e.satProduct);
+        globalWant[G_RNG_ERROR] = e.rngError;
+        globalWant[G_PROD_IS_NEG] = e.prodIsNeg;
+        globalWant[G_FINAL_PRODUCT] = e.satProduct;
+        end();
+    }
+}
+
+
+// the kernels that take arrays: w is x and a, its reverse is y and b
+static void fuzzArrays(const uint32_t *w, uint32_t n)
+{
+    uint32_t rev[FUZZ_MAX_WORDS];
+    uint32_t f;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        rev[i] = w[n - 1 - i];
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmMainBatch")) != 0)
+    {
+        begin("asmMainBatch", n);
+        input(0, w, n);
+        call(f, (uint32_t[]){ scratch, scratch + 4 * n, n }, 3, NULL);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            expectedValues e;
+            calcExpectedValues(0, "", w[i], &e);
+            scratchWant[n + i] = e.finalProduct;
+        }
+        end();
+    }
+
+    int64_t acc = (int64_t)(((uint64_t)w[0] << 32) | w[n - 1]);
+    if ((f = emuSymbolAddr(&img, "asmDot16")) != 0)
+    {
+        uint32_t r1 = 0;
+        begin("asmDot16", n);
+        input(0, w, n);
+        input(n, rev, n);
+        uint32_t r0 = call(f, (uint32_t[]){ scratch, scratch + 4 * n, n }, 3, &r1);
+        int64_t want = calcExpectedDot16(0, w, rev, n);
+        if ((int64_t)(((uint64_t)r1 << 32) | r0) != want)
+        {
+            fail("r1:r0", (int64_t)(((uint64_t)r1 << 32) | r0), want);
+        }
+        end();
+    }
+    if ((f = emuSymbolAddr(&img, "asmMac16")) != 0)
+    {
+        uint32_t r1 = 0;
+        begin("asmMac16", n);
+        input(0, w, n);
+        input(n, rev, n);
+        uint32_t r0 = call(f, (uint32_t[]){ (uint32_t)acc, (uint32_t)((uint64_t)acc >> 32),
+                scratch, scratch + 4 * n, n }, 5, &r1);
+        int64_t want = calcExpectedDot16(acc, w, rev, n);
+        if ((int64_t)(((uint64_t)r1 << 32) | r0) != want)
+        {
+            fail("r1:r0", (int64_t)(((uint64_t)r1 << 32) | r0), want);
+        }
+        end();
+    }
+
+    if ((f = emuSymbolAddr(&img, "asmMultN")) != 0)
+    {
+        // r[0..2n), then a, then b
+        begin("asmMultN", n);
+        input(2 * n, w, n);
+        input(3 * n, rev, n);
+        call(f, (uint32_t[]){ scratch, scratch + 8 * n, scratch + 12 * n, n }, 4, NULL);
+        calcExpectedMultN(scratchWant, w, rev, n);
+        end();
+    }
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint32_t w[FUZZ_MAX_WORDS];
+    uint32_t n = (uint32_t)(size / 4);
+
+    if (cpu.uc == NULL)
+    {
+        fuzzInit();
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    if (n > FUZZ_MAX_WORDS)
+    {
+        n = FUZZ_MAX_WORDS;
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        w[i] = (uint32_t)data[4 * i] | ((uint32_t)data[4 * i + 1] << 8) |
+               ((uint32_t)data[4 * i + 2] << 16) | ((uint32_t)data[4 * i + 3] << 24);
+        fuzzValue(w[i]);
+    }
+    fuzzArrays(w, n);
+    return 0;
+}
+
+
+#ifdef FUZZ_STANDALONE
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Main Entry Point                                                  */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// without libFuzzer: run each file named on the command line once
+int main(int argc, char **argv)
+{
+    static uint8_t data[4 * FUZZ_MAX_WORDS];
+
+    for (int i = 1; i < argc; ++i)
+    {
+        FILE *f = fopen(argv[i], "rb");
+        if (f == NULL)
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        size_t len = fread(data, 1, sizeof(data), f);
+        fclose(f);
+        LLVMFuzzerTestOneInput(data, len);
+    }
+    printf("%d inputs, no mismatches\n", argc - 1);
+    return 0;
+}
+#endif /* FUZZ_STANDALONE */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,71 @@
+/* ************************************************************************** */
+/** Host versions of the hardware-facing functions
+
+  @File Name
+    hostStubs.c
+
+  @Summary
+    printFuncs.c, benchInit and the DWT cycle counter for a PC build.
+
+  @Description
+    Prints go to stdout, and a transfer is "complete" as soon as the
+    call returns, the same as printFuncs.c with USING_HW set to 0.
+    hostQuiet drops the prints, for tests that expect failures.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "definitions.h"
+#include "printFuncs.h"
+#include "benchFuncs.h"
+#include "hostStubs.h"
+
+bool hostQuiet = false;
+
+static hostDwtRegs dwtRegs;
+
+
+hostDwtRegs *hostDwt(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // wraps every 2^32 cycles, like the real one
+    uint64_t ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    dwtRegs.CYCCNT = (uint32_t)(ns * (CPU_CLOCK_FREQUENCY / 1000000) / 1000);
+    return &dwtRegs;
+}
+
+
+void benchInit(void)
+{
+    // nothing to enable; hostDwt always counts
+}
+
+
+void printAndWait(char *txBuffer, volatile bool *txCompletePtr)
+{
+    if (hostQuiet == false)
+    {
+        fputs(txBuffer, stdout);
+    }
+    *txCompletePtr = false;
+}
+
+
+void printNoWait(char *txBuffer, volatile bool *txCompletePtr)
+{
+    if (hostQuiet == false)
+    {
+        fputs(txBuffer, stdout);
+    }
+    *txCompletePtr = true;
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,34 @@
+/* ************************************************************************** */
+/** Host versions of the hardware-facing functions
+
+  @File Name
+    hostStubs.h
+
+  @Summary
+    Switches for hostStubs.c. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _HOST_STUBS_H    /* Guard against multiple inclusion */
+#define _HOST_STUBS_H
+
+#include <stdbool.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// true: printAndWait/printNoWait print nothing
+extern bool hostQuiet;
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HOST_STUBS_H */
+
+/* *****************************************************************************
+ End of File
+ */
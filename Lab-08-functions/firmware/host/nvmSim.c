@@ -0,0 +1,134 @@
+/* ************************************************************************** */
+/** Host model of the NVMCTRL SmartEEPROM
+
+  @File Name
+    nvmSim.c
+
+  @Summary
+    Register model behind NVMCTRL_REGS, and the SmartEEPROM behind
+    nvmSimSee(), for off-target builds.
+
+  @Description
+    Only the SmartEEPROM side is modeled: SEESTAT (SBLK, PSZ, LOCK and
+    BUSY) and the data itself. Writes to the window land at once; BUSY
+    just checks that callers wait for it. Flash commands through CTRLB
+    are accepted and ignored. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifdef NVMCTRL_HOST_SIM
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "device.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "nvmSim.h"
+
+// SEESTAT (offset 0x2C) is read-only in nvmctrl_registers_t, so the
+// model writes it through this view of the same memory
+typedef union
+{
+    nvmctrl_registers_t regs;
+    uint8_t bytes[sizeof(nvmctrl_registers_t)];
+} nvmSimMem;
+
+static nvmSimMem sim;
+static uint32_t see[NVM_SIM_SEE_BYTES / 4];
+static uint32_t fuses = 0;         // SEESTAT.SBLK and PSZ
+static bool lockBit = false;
+static uint32_t busyReads = 0;
+
+uint32_t nvmSimAccesses = 0;
+uint32_t nvmSimBusyAccesses = 0;
+uint32_t nvmSimBadAccesses = 0;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static void setSeeStat(void)
+{
+    uint32_t stat = fuses;
+
+    if (lockBit)
+    {
+        stat |= NVMCTRL_SEESTAT_LOCK_Msk;
+    }
+    if (busyReads != 0)
+    {
+        stat |= NVMCTRL_SEESTAT_BUSY_Msk;
+    }
+    memcpy(&sim.bytes[offsetof(nvmctrl_registers_t, NVMCTRL_SEESTAT)], &stat, sizeof(stat));
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+nvmctrl_registers_t *nvmSimRegs(void)
+{
+    // this access sees the current BUSY; the next one may not
+    setSeeStat();
+    if (busyReads != 0)
+    {
+        busyReads -= 1;
+    }
+    return &sim.regs;
+}
+
+
+volatile uint32_t *nvmSimSee(void)
+{
+    nvmSimAccesses += 1;
+    if (busyReads != 0)
+    {
+        nvmSimBusyAccesses += 1;
+    }
+    if ((fuses & NVMCTRL_SEESTAT_SBLK_Msk) == 0U)
+    {
+        nvmSimBadAccesses += 1;
+    }
+    busyReads = NVM_SIM_BUSY_READS;
+    return see;
+}
+
+
+void nvmSimReset(uint32_t sblk, uint32_t psz)
+{
+    fuses = NVMCTRL_SEESTAT_SBLK(sblk) | NVMCTRL_SEESTAT_PSZ(psz);
+    lockBit = false;
+    nvmSimAccesses = 0;
+    nvmSimBusyAccesses = 0;
+    nvmSimBadAccesses = 0;
+    memset(see, 0xFF, sizeof(see));
+    nvmSimReboot();
+}
+
+
+void nvmSimReboot(void)
+{
+    memset(&sim, 0, sizeof(sim));
+    busyReads = 0;
+    setSeeStat();
+}
+
+
+void nvmSimLock(bool locked)
+{
+    lockBit = locked;
+    setSeeStat();
+}
+
+#endif /* NVMCTRL_HOST_SIM */
+
+/* *****************************************************************************
+ End of File
+ */
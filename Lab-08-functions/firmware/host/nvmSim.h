@@ -0,0 +1,78 @@
+/* ************************************************************************** */
+/** Host model of the NVMCTRL SmartEEPROM
+
+  @File Name
+    nvmSim.h
+
+  @Summary
+    Stands in for the NVMCTRL registers and the SmartEEPROM window when
+    plib_nvmctrl.c and benchStore.c are built on a PC with
+    NVMCTRL_HOST_SIM defined.
+
+  @Description
+    NVMCTRL_REGS becomes a call to nvmSimRegs(), and benchStore.c reaches
+    the SmartEEPROM through nvmSimSee() instead of SEEPROM_ADDR. The
+    model has the fuse settings (SEESTAT.SBLK/PSZ), the write lock, and
+    a BUSY bit that stays set for a couple of status reads after each
+    access. Its contents survive nvmSimReboot(), like the flash behind
+    the real one. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _NVM_SIM_H    /* Guard against multiple inclusion */
+#define _NVM_SIM_H
+
+#ifdef NVMCTRL_HOST_SIM
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "device.h"
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the smallest SmartEEPROM (SEESBLK = 1, SEEPSZ = 0)
+#define NVM_SIM_SEE_BYTES 512
+
+// status reads that see BUSY after each access
+#define NVM_SIM_BUSY_READS 2
+
+#undef NVMCTRL_REGS
+#define NVMCTRL_REGS (nvmSimRegs())
+
+extern uint32_t nvmSimAccesses;      // nvmSimSee() calls
+extern uint32_t nvmSimBusyAccesses;  // ... made while BUSY was set
+extern uint32_t nvmSimBadAccesses;   // ... made with SEESBLK = 0 (a bus
+                                     // fault on the chip)
+
+// step the model and return its registers
+nvmctrl_registers_t *nvmSimRegs(void);
+
+// the SmartEEPROM window, NVM_SIM_SEE_BYTES long
+volatile uint32_t *nvmSimSee(void);
+
+// set the SEESBLK/SEEPSZ fuses, unlock, clear the counters and erase
+// the SmartEEPROM to all ones
+void nvmSimReset(uint32_t sblk, uint32_t psz);
+
+// like a reset of the chip: registers go back to their reset values
+// (the fuses and lock stay), the SmartEEPROM keeps its contents
+void nvmSimReboot(void);
+
+// set or clear SEESTAT.LOCK
+void nvmSimLock(bool locked);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVMCTRL_HOST_SIM */
+
+#endif /* _NVM_SIM_H */
+
+/* *****************************************************************************
+ End of File
+ */
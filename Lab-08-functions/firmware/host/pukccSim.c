@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/** Host model of the PUKCC
+
+  @File Name
+    pukccSim.c
+
+  @Summary
+    Stands in for the crypto RAM, PUKCCSR and the PUKCL ROM entry when
+    pukccMult.c is built on a PC with PUKCC_HOST_SIM defined.
+
+  @Description
+    Only the services pukccMult.c uses are modeled. Fmult checks the
+    parameter block the way the ROM would: operand pointers must be word
+    aligned and inside the crypto RAM, lengths a multiple of 4, and the
+    result area must not overlap X or Y. A bad block gives an error
+    status instead of a product. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifdef PUKCC_HOST_SIM
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pukccMult.h"
+
+// status codes the model returns besides PUKCL_OK
+#define SIM_BAD_SERVICE  0xC001
+#define SIM_BAD_PARAMS   0xC002
+#define SIM_FORCED_FAIL  0xC003
+
+uint32_t pukccSimCryptoRam[PUKCC_CRYPTO_RAM_SIZE / 4];
+volatile uint32_t pukccSimCsr = 0;
+uint32_t pukccSimCalls = 0;
+bool pukccSimFailSelfTest = false;
+bool pukccSimFailFmult = false;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// true if [nu1, nu1 + len) is word aligned and inside the crypto RAM
+static bool areaOk(uint16_t nu1, uint32_t len)
+{
+    uint32_t off = PUKCC_NU1_OFFSET(nu1);
+    return ((off % 4) == 0) && ((len % 4) == 0) && (len != 0)
+            && (off + len <= PUKCC_CRYPTO_RAM_SIZE);
+}
+
+static bool overlaps(uint16_t nu1a, uint32_t lenA, uint16_t nu1b, uint32_t lenB)
+{
+    uint32_t a = PUKCC_NU1_OFFSET(nu1a);
+    uint32_t b = PUKCC_NU1_OFFSET(nu1b);
+    return (a < b + lenB) && (b < a + lenA);
+}
+
+static void fmult(pukclParams *params)
+{
+    uint32_t xLen = params->p.fmult.xLength;
+    uint32_t yLen = params->p.fmult.yLength;
+    uint32_t rLen = xLen + yLen;
+    uint16_t xBase = params->p.fmult.xBase;
+    uint16_t yBase = params->p.fmult.yBase;
+    uint16_t rBase = params->p.fmult.rBase;
+
+    if ((params->option != PUKCL_FMULT_ONLY)
+            || !areaOk(xBase, xLen) || !areaOk(yBase, yLen) || !areaOk(rBase, rLen)
+            || overlaps(rBase, rLen, xBase, xLen) || overlaps(rBase, rLen, yBase, yLen))
+    {
+        params->status = SIM_BAD_PARAMS;
+        return;
+    }
+    if (pukccSimFailFmult)
+    {
+        params->status = SIM_FORCED_FAIL;
+        return;
+    }
+
+    uint32_t *x = &pukccSimCryptoRam[PUKCC_NU1_OFFSET(xBase) / 4];
+    uint32_t *y = &pukccSimCryptoRam[PUKCC_NU1_OFFSET(yBase) / 4];
+    uint32_t *r = &pukccSimCryptoRam[PUKCC_NU1_OFFSET(rBase) / 4];
+    uint32_t xWords = xLen / 4;
+    uint32_t yWords = yLen / 4;
+
+    memset(r, 0, rLen);
+    for (uint32_t i = 0; i < yWords; ++i)
+    {
+        uint64_t carry = 0;
+        for (uint32_t j = 0; j < xWords; ++j)
+        {
+            carry += (uint64_t)x[j] * y[i] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        r[i + xWords] = (uint32_t)carry;
+    }
+    params->status = PUKCL_OK;
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+void pukccSimProcess(pukclParams *params)
+{
+    pukccSimCalls += 1;
+    switch (params->service)
+    {
+        case PUKCL_SERVICE_SELF_TEST:
+            params->status = pukccSimFailSelfTest ? SIM_FORCED_FAIL : PUKCL_OK;
+            params->p.selfTest.version = PUKCC_SIM_VERSION;
+            break;
+        case PUKCL_SERVICE_FMULT:
+            fmult(params);
+            break;
+        default:
+            params->status = SIM_BAD_SERVICE;
+            break;
+    }
+}
+
+
+void pukccSimReset(void)
+{
+    memset(pukccSimCryptoRam, 0, sizeof(pukccSimCryptoRam));
+    pukccSimCsr = 0;
+    pukccSimCalls = 0;
+    pukccSimFailSelfTest = false;
+    pukccSimFailFmult = false;
+}
+
+#endif /* PUKCC_HOST_SIM */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/** C reference models of the asmMult.s kernels
+
+  @File Name
+    refKernels.c
+
+  @Summary
+    See refKernels.h. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "asmExterns.h"
+#include "refKernels.h"
+
+// the asmMult.s debug globals
+int32_t a_Multiplicand = 0;
+int32_t b_Multiplier = 0;
+int32_t rng_Error = 0;
+int32_t a_Sign = 0;
+int32_t b_Sign = 0;
+int32_t prod_Is_Neg = 0;
+int32_t a_Abs = 0;
+int32_t b_Abs = 0;
+int32_t init_Product = 0;
+int32_t final_Product = 0;
+
+
+void refUnpack(uint32_t packedValue, int32_t *a, int32_t *b)
+{
+    *a = (int32_t)packedValue >> 16;   // ASR 16
+    *b = (int16_t)packedValue;         // SXTH
+}
+
+
+int32_t refAbs(int32_t input, int32_t *absOut, int32_t *signBit)
+{
+    int32_t sign = 0;
+
+    if (input < 0)
+    {
+        input = (int32_t)(0U - (uint32_t)input);   // NEG, wraps like it
+        sign = 1;
+    }
+    *absOut = input;
+    *signBit = sign;
+    return input;
+}
+
+
+int32_t refMult(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a * (uint32_t)b);
+}
+
+
+int32_t refFixSign(int32_t initProduct, int32_t signBitA, int32_t signBitB)
+{
+    if (((signBitA + signBitB) & 1) != 0)
+    {
+        return (int32_t)(0U - (uint32_t)initProduct);
+    }
+    return initProduct;
+}
+
+
+int32_t refMain(uint32_t packedValue)
+{
+    refUnpack(packedValue, &a_Multiplicand, &b_Multiplier);
+    refAbs(a_Multiplicand, &a_Abs, &a_Sign);
+    refAbs(b_Multiplier, &b_Abs, &b_Sign);
+    init_Product = refMult(a_Abs, b_Abs);
+    final_Product = refFixSign(init_Product, a_Sign, b_Sign);
+    return final_Product;
+}
+
+
+void refMainBatch(const uint32_t *packed, int32_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        // SMULTB: signed top half * signed bottom half
+        out[i] = (int32_t)(int16_t)(packed[i] >> 16) * (int16_t)packed[i];
+    }
+}
+
+
+void refMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    // one row of UMAAL per word of b: r[i+j] + a[j]*b[i] + carry
+    for (size_t i = 0; i < 2 * n; ++i)
+    {
+        r[i] = 0;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t carry = 0;
+        for (size_t j = 0; j < n; ++j)
+        {
+            uint64_t t = (uint64_t)a[j] * b[i] + r[i + j] + carry;
+            r[i + j] = (uint32_t)t;
+            carry = (uint32_t)(t >> 32);
+        }
+        r[i + n] = carry;
+    }
+}
+
+
+// multN.c calls asmMultN by name, so the host build links this in its place
+void asmMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    refMultN(r, a, b, n);
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,62 @@
+/* ************************************************************************** */
+/** C reference models of the asmMult.s kernels
+
+  @File Name
+    refKernels.h
+
+  @Summary
+    The five lab kernels, asmMainBatch and asmMultN, in C, for the host
+    build.
+
+  @Description
+    Same arguments and results as the asm versions, step for step, so
+    they can go in a kernelTest row (testRunner.h) in place of the asm
+    ones. refMain sets the same globals asmMain does; refKernels.c
+    defines them, since asmMult.s isn't built on the host. For the same
+    reason it defines asmMultN itself, so multN.c links unchanged.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _REF_KERNELS_H    /* Guard against multiple inclusion */
+#define _REF_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// asmUnpack: a = top 16 bits, b = bottom 16 bits, both sign-extended
+void refUnpack(uint32_t packedValue, int32_t *a, int32_t *b);
+
+// asmAbs: returns and stores |input|; sign bit 1 for negative
+int32_t refAbs(int32_t input, int32_t *absOut, int32_t *signBit);
+
+// asmMult: a * b for 0 <= a, b <= 2^16, low 32 bits
+int32_t refMult(int32_t a, int32_t b);
+
+// asmFixSign: -initProduct if exactly one sign bit is set
+int32_t refFixSign(int32_t initProduct, int32_t signBitA, int32_t signBitB);
+
+// asmMain: the four steps above, through the globals
+int32_t refMain(uint32_t packedValue);
+
+// asmMainBatch: out[i] = a[i] * b[i], globals untouched
+void refMainBatch(const uint32_t *packed, int32_t *out, size_t n);
+
+// asmMultN: r[0..2n) = a[0..n) * b[0..n), schoolbook
+void refMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _REF_KERNELS_H */
+
+/* *****************************************************************************
+ End of File
+ */
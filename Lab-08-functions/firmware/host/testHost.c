@@ -0,0 +1,663 @@
+/* ************************************************************************** */
+/** Host unit tests for the test harness
+
+  @File Name
+    testHost.c
+
+  @Summary
+    Checks testFuncs.c, testRunner.c, randVectors.c, benchStore.c,
+    firFilter.c, divConst.c and the PUKCC driver on a PC.
+
+  @Description
+    Runs the same runner code the board does, against the C reference
+    kernels in refKernels.c, plus a few broken kernels to make sure the
+    checkers notice. Takes milliseconds, so the harness can be changed
+    and re-checked without flashing the board. "make test" runs it;
+    the exit status is the number of failed checks.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "definitions.h"
+#include "testFuncs.h"
+#include "testRunner.h"
+#include "randVectors.h"
+#include "trngSim.h"
+#include "benchStore.h"
+#include "nvmSim.h"
+#include "multN.h"
+#include "pukccMult.h"
+#include "firFilter.h"
+#include "divConst.h"
+#include "hostStubs.h"
+#include "refKernels.h"
+#include "testVectors.h"
+
+static int checksRun = 0;
+static int checksFailed = 0;
+
+// count a check, and print it if it fails
+#define CHECK(cond) \
+    do { \
+        ++checksRun; \
+        if (!(cond)) { \
+            ++checksFailed; \
+            printf("%s:%d: CHECK FAILED: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+// expected values for tc[] (testVectors.c)
+static expectedValues tcExpected[NUM_TEST_CASES];
+static volatile bool txComplete = false;
+static volatile bool rtcExpired = true;
+
+static bool doAllTests = true;
+
+enum { KT_UNPACK, KT_ABS, KT_MULT, KT_FIX_SIGN, KT_MAIN, NUM_KERNEL_TESTS };
+static const kernelTest refTests[NUM_KERNEL_TESTS] = {
+    [KT_UNPACK]   = { "refUnpack",  (kernelFunc)refUnpack,  checkUnpackCase,  &doAllTests },
+    [KT_ABS]      = { "refAbs",     (kernelFunc)refAbs,     checkAbsCase,     &doAllTests },
+    [KT_MULT]     = { "refMult",    (kernelFunc)refMult,    checkMultCase,    &doAllTests },
+    [KT_FIX_SIGN] = { "refFixSign", (kernelFunc)refFixSign, checkFixSignCase, &doAllTests },
+    [KT_MAIN]     = { "refMain",    (kernelFunc)refMain,    checkMainCase,    &doAllTests },
+};
+static kernelTestResults results[NUM_KERNEL_TESTS];
+
+
+// the usual student bug: sign fixed from b only
+static int32_t badFixSign(int32_t initProduct, int32_t signBitA, int32_t signBitB)
+{
+    (void)signBitA;
+    return refFixSign(initProduct, 0, signBitB);
+}
+
+// wrong whenever b is -32768
+static void badMainBatch(const uint32_t *packed, int32_t *out, size_t n)
+{
+    refMainBatch(packed, out, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if ((packed[i] & 0xFFFF) == 0x8000)
+        {
+            out[i] ^= 1;
+        }
+    }
+}
+
+
+static void testCalcExpectedValues(void)
+{
+    expectedValues e;
+
+    calcExpectedValues(1, "", 0xFFFC0003, &e);
+    CHECK(e.inputA == -4);
+    CHECK(e.inputB == 3);
+    CHECK(e.absA == 4 && e.signA == 1);
+    CHECK(e.absB == 3 && e.signB == 0);
+    CHECK(e.initProduct == 12);
+    CHECK(e.finalProduct == -12);
+
+    calcExpectedValues(7, "", 0x80008000, &e);
+    CHECK(e.inputA == -32768 && e.inputB == -32768);
+    CHECK(e.absA == 32768 && e.absB == 32768);
+    CHECK(e.finalProduct == 0x40000000);
+
+    calcExpectedValuesN(tc, NUM_TEST_CASES, tcExpected);
+    for (uint32_t i = 0; i < NUM_TEST_CASES; ++i)
+    {
+        CHECK(tcExpected[i].packedVal == (uint32_t)tc[i]);
+        CHECK(tcExpected[i].finalProduct ==
+                (int16_t)(tc[i] >> 16) * (int16_t)tc[i]);
+    }
+}
+
+
+static void testRunnerWithRefKernels(void)
+{
+    hostQuiet = false;
+    runKernelTests(refTests, results, NUM_KERNEL_TESTS, tcExpected, NUM_TEST_CASES,
+            true, true, &rtcExpired, &txComplete);
+    for (uint32_t k = 0; k < NUM_KERNEL_TESTS; ++k)
+    {
+        CHECK(results[k].failCount == 0);
+        CHECK(results[k].numCases == NUM_TEST_CASES);
+        CHECK(results[k].passCount == results[k].numTests);
+        CHECK(results[k].numTests > 0);
+    }
+}
+
+
+static void testRunnerCatchesBadKernel(void)
+{
+    kernelTest badTests[NUM_KERNEL_TESTS];
+    kernelTestResults badResults[NUM_KERNEL_TESTS];
+
+    memcpy(badTests, refTests, sizeof(badTests));
+    badTests[KT_FIX_SIGN].kernel = (kernelFunc)badFixSign;
+
+    hostQuiet = true;
+    runKernelTests(badTests, badResults, NUM_KERNEL_TESTS, tcExpected, NUM_TEST_CASES,
+            true, true, &rtcExpired, &txComplete);
+    hostQuiet = false;
+
+    // wrong for the three tc[] cases with a < 0 and a non-zero product
+    CHECK(badResults[KT_FIX_SIGN].failCount == 3);
+    CHECK(badResults[KT_MAIN].failCount == 0);
+    CHECK(badResults[KT_UNPACK].failCount == 0);
+}
+
+
+// C stand-ins for the table rows whose kernels are asm-only
+static void refQ15Group(uint32_t x, uint32_t y, int32_t acc, int32_t gain, q15Results *r)
+{
+    r->mul = q15MulRef(x, y);
+    r->mac = q15MacRef(acc, x, y);
+    r->add = q15AddRef(x, y);
+    r->sub = q15SubRef(x, y);
+    r->scale = q15ScaleRef(x, gain);
+}
+
+static void refDivGroup(int32_t n, int32_t d, divResults *r)
+{
+    calcExpectedDiv(n, d, r);
+}
+
+// what asmUDivConst does with the divMagicInit numbers
+static uint32_t refUDivConst(uint32_t n, const divMagic *m)
+{
+    uint32_t t = (uint32_t)(((uint64_t)n * m->magic) >> 32);
+    return (t + ((n - t) >> m->shift1)) >> m->shift2;
+}
+
+static void refUDivConstN(const uint32_t *in, uint32_t *out, size_t n, const divMagic *m)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = refUDivConst(in[i], m);
+    }
+}
+
+// the rows main.c adds after the lab kernels, with C kernels
+enum { OT_MAIN_BATCH, OT_MULT_N, OT_KARATSUBA, OT_PUKCC_MULT, OT_PUKCC_MOD_MULT,
+       OT_Q15, OT_DIV, OT_UDIV_CONST, OT_UDIV_CONST_N, OT_FIR, NUM_OTHER_TESTS };
+static const kernelTest otherTests[NUM_OTHER_TESTS] = {
+    [OT_MAIN_BATCH]  = { "refMainBatch", (kernelFunc)refMainBatch, checkMainBatchCase, &doAllTests },
+    [OT_MULT_N]      = { "refMultN",  (kernelFunc)refMultN,  checkMultNCase,  &doAllTests, MULTN_TEST_CASES },
+    [OT_KARATSUBA]   = { "Karatsuba", (kernelFunc)multNKaratsuba, checkKaratsubaCase, &doAllTests, MULTN_TEST_CASES },
+    [OT_PUKCC_MULT]  = { "pukccMultN", (kernelFunc)pukccMultN, checkPukccMultCase, &doAllTests, PUKCC_TEST_CASES },
+    [OT_PUKCC_MOD_MULT] = { "pukccModMultN", (kernelFunc)pukccModMultN, checkPukccModMultCase, &doAllTests, PUKCC_TEST_CASES },
+    [OT_Q15]         = { "refQ15",    (kernelFunc)refQ15Group, checkQ15Case,  &doAllTests, Q15_TEST_CASES },
+    [OT_DIV]         = { "refDiv",    (kernelFunc)refDivGroup, checkDivCase,  &doAllTests, DIV_TEST_CASES },
+    [OT_UDIV_CONST]  = { "refUDivConst", (kernelFunc)refUDivConst, checkUDivConstCase, &doAllTests, DIV_CONST_TEST_CASES },
+    [OT_UDIV_CONST_N] = { "refUDivConstN", (kernelFunc)refUDivConstN, checkUDivConstNCase, &doAllTests, DIV_CONST_TEST_CASES },
+    [OT_FIR]         = { "firProcess", (kernelFunc)firProcess, checkFirCase,  &doAllTests, FIR_TEST_CASES },
+};
+
+
+static void testRunnerOwnCases(void)
+{
+    kernelTestResults otherResults[NUM_OTHER_TESTS];
+    kernelTest badTests[NUM_OTHER_TESTS];
+
+    pukccSimReset();
+    pukccInit();
+    uint32_t hwCalls = pukccHwCalls;
+    runKernelTests(otherTests, otherResults, NUM_OTHER_TESTS, tcExpected, NUM_TEST_CASES,
+            true, true, &rtcExpired, &txComplete);
+    for (uint32_t k = 0; k < NUM_OTHER_TESTS; ++k)
+    {
+        uint32_t cases = (otherTests[k].numCases != 0) ? otherTests[k].numCases : NUM_TEST_CASES;
+        CHECK(otherResults[k].failCount == 0);
+        CHECK(otherResults[k].numCases == cases);
+        CHECK(otherResults[k].numTests > 0);
+    }
+    // 3 of the 5 sizes are over the threshold: one multiply each for
+    // pukccMultN, three for pukccModMultN (the 15 word case's Barrett
+    // multiplies are 16 words, so it adds 2 more)
+    CHECK(pukccHwCalls - hwCalls == 3 + 3 * 3 + 2);
+
+    // a kernel that is only wrong for b == -32768 fails every prefix
+    // from tc[7] (0x80008000) on
+    memcpy(badTests, otherTests, sizeof(badTests));
+    badTests[OT_MAIN_BATCH].kernel = (kernelFunc)badMainBatch;
+    hostQuiet = true;
+    runKernelTests(badTests, otherResults, 1, tcExpected, NUM_TEST_CASES,
+            true, true, &rtcExpired, &txComplete);
+    hostQuiet = false;
+    CHECK(otherResults[OT_MAIN_BATCH].failCount >= NUM_TEST_CASES - 7);
+}
+
+
+static void testRandomAndSweep(void)
+{
+    sweepResults r;
+    sweepResults r2;
+
+    randomPackedTests(refMainBatch, "refMainBatch", 12345, 64, &r, &txComplete);
+    CHECK(r.numVals == 64 * 256);
+    CHECK(r.mismatches == 0);
+
+    // a fixed seed replays exactly, so a bad kernel fails the same way
+    hostQuiet = true;
+    randomPackedTests(badMainBatch, "badMainBatch", 12345, 4096, &r, &txComplete);
+    randomPackedTests(badMainBatch, "badMainBatch", 12345, 4096, &r2, &txComplete);
+    hostQuiet = false;
+    CHECK(r.mismatches > 0);
+    CHECK(r.mismatches == r2.mismatches);
+
+    // seed 0 comes from the TRNG model, which is seeded too
+    trngSimReset(42);
+    TRNG_Initialize();
+    uint32_t s1 = randSeedFromTrng();
+    trngSimReset(42);
+    TRNG_Initialize();
+    uint32_t s2 = randSeedFromTrng();
+    CHECK(s1 == s2);
+    CHECK(trngSimInterrupts > 0);
+
+    randVectors a;
+    randVectors b;
+    uint32_t x[300];
+    uint32_t y[300];
+    randVectorsInit(&a, s1);
+    randVectorsFill(&a, x, 300);
+    randVectorsInit(&b, s1);
+    randVectorsFill(&b, y, 100);
+    randVectorsFill(&b, y + 100, 200);
+    CHECK(memcmp(x, y, sizeof(x)) == 0);
+    CHECK(b.count == 300);
+
+    // every 65537th value: a and b both walk all 65536 values
+    sweepPackedInputs(refMainBatch, "refMainBatch", 65537, &r, &txComplete);
+    CHECK(r.numVals == 65536);
+    CHECK(r.mismatches == 0);
+
+    hostQuiet = true;
+    sweepPackedInputs(badMainBatch, "badMainBatch", 0x8001, &r, &txComplete);
+    hostQuiet = false;
+    CHECK(r.mismatches > 0);
+}
+
+
+static void testOtherRefs(void)
+{
+    divResults d;
+
+    calcExpectedDiv(7, -2, &d);
+    CHECK(d.quot == -3 && d.rem == 1);
+    calcExpectedDiv(5, 0, &d);
+    CHECK(d.quot == 0 && d.rem == 5 && d.uQuot == 0 && d.uRem == 5);
+    calcExpectedDiv(INT32_MIN, -1, &d);
+    CHECK(d.quot == INT32_MIN && d.rem == 0);
+
+    uint32_t a[2] = { 0xFFFFFFFF, 0x00000001 };
+    uint32_t b[2] = { 0x00000002, 0x00000000 };
+    uint32_t prod[4];
+    calcExpectedMultN(prod, a, b, 2);
+    CHECK(prod[0] == 0xFFFFFFFE && prod[1] == 0x00000003);
+    CHECK(prod[2] == 0 && prod[3] == 0);
+
+    int64_t acc = calcExpectedDot16(10, (const uint32_t[]){ 0x00020003 },
+            (const uint32_t[]){ 0xFFFF0004 }, 1);
+    CHECK(acc == 10 - 2 + 12);
+
+    // -1-1j * -1-1j = +2.0j saturates; a 32 bit sum wraps it to -1.0j
+    CHECK(q15CmulRef(0x80008000, 0x80008000, false) == 0x7FFF0000);
+    CHECK(q15CmulRef(0x80008000, 0x80008000, true) == 0x00007FFF);
+    CHECK(q15CmulRef(0x40000000, 0x40000000, false) == 0x0000E000);
+}
+
+
+static void testBenchStore(void)
+{
+    static benchRun run;
+    static benchBaseline base;
+
+    nvmSimReset(1, 0);
+    NVMCTRL_Initialize();
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+    CHECK(benchRecordId("asmMain", BENCH_KIND_CYCLES) !=
+            benchRecordId("asmMain", BENCH_KIND_PASSES));
+
+    // first boot: everything is new and becomes the baseline
+    benchRunReset(&run);
+    benchRunAdd(&run, "asmMain", BENCH_KIND_CYCLES, 100);
+    benchRunAdd(&run, "asmMultHw", BENCH_KIND_CYCLES, 10);
+    benchRunAdd(&run, "asmMain", BENCH_KIND_PASSES, 5);
+    hostQuiet = true;
+    CHECK(benchStoreBoot(&run, 5, false, &txComplete) == 0);
+    hostQuiet = false;
+    CHECK(run.status[0] == BENCH_STATUS_NEW && run.status[2] == BENCH_STATUS_NEW);
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK);
+    CHECK(base.numRecords == 3 && base.saves == 1);
+
+    // next boot: within 5%, over 5% (and the 2 cycle slack), fewer
+    // passes, and a value the baseline doesn't have yet
+    nvmSimReboot();
+    benchRunReset(&run);
+    benchRunAdd(&run, "asmMain", BENCH_KIND_CYCLES, 104);
+    benchRunAdd(&run, "asmMultHw", BENCH_KIND_CYCLES, 13);
+    benchRunAdd(&run, "asmMain", BENCH_KIND_PASSES, 4);
+    benchRunAdd(&run, "asmDot16", BENCH_KIND_CYCLES, 50);
+    hostQuiet = true;
+    CHECK(benchStoreBoot(&run, 5, false, &txComplete) == 2);
+    hostQuiet = false;
+    CHECK(run.status[0] == BENCH_STATUS_OK);
+    CHECK(run.status[1] == BENCH_STATUS_REGRESSED && run.baseValues[1] == 10);
+    CHECK(run.status[2] == BENCH_STATUS_REGRESSED);
+    CHECK(run.status[3] == BENCH_STATUS_NEW);
+    // the new value was added; the old ones stay as they were
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK);
+    CHECK(base.numRecords == 4 && base.saves == 2);
+    CHECK(base.records[1].value == 10);
+
+    // nothing new: the baseline isn't rewritten
+    hostQuiet = true;
+    CHECK(benchStoreBoot(&run, 5, false, &txComplete) == 2);
+    hostQuiet = false;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK && base.saves == 2);
+
+    // rebase: flagged once more, then the new numbers are the baseline
+    hostQuiet = true;
+    CHECK(benchStoreBoot(&run, 5, true, &txComplete) == 2);
+    CHECK(benchStoreBoot(&run, 5, false, &txComplete) == 0);
+    hostQuiet = false;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK && base.saves == 3);
+    run.records[0].value = 90;
+    CHECK(benchStoreCompare(&base, &run, 5) == 0);
+    CHECK(run.status[0] == BENCH_STATUS_IMPROVED);
+    CHECK(nvmSimBusyAccesses == 0 && nvmSimBadAccesses == 0);
+
+    // a flipped bit, or a save cut short before the magic went back
+    nvmSimSee()[5] ^= 0x100;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+    nvmSimSee()[5] ^= 0x100;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK);
+    // the header is covered too: a bad save count or record count
+    nvmSimSee()[2] ^= 1;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+    nvmSimSee()[2] ^= 1;
+    nvmSimSee()[1] ^= 0x10000;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+    nvmSimSee()[1] ^= 0x10000;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_OK);
+    nvmSimSee()[0] = 0;
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+
+    // no SmartEEPROM: reported, and never touched
+    nvmSimReset(0, 0);
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_DISABLED);
+    hostQuiet = true;
+    CHECK(benchStoreBoot(&run, 5, false, &txComplete) == 0);
+    hostQuiet = false;
+    CHECK(nvmSimAccesses == 0);
+
+    nvmSimReset(1, 0);
+    nvmSimLock(true);
+    CHECK(benchStoreSave(&base) == BENCH_STORE_LOCKED);
+    CHECK(benchStoreLoad(&base) == BENCH_STORE_EMPTY);
+
+    benchRunReset(&run);
+    for (uint32_t i = 0; i < BENCH_STORE_MAX_RECORDS; ++i)
+    {
+        benchRunAdd(&run, "x", BENCH_KIND_CYCLES, i);
+    }
+    CHECK(benchRunAdd(&run, "x", BENCH_KIND_CYCLES, 0) == false);
+    CHECK(sizeof(benchBaseline) == BENCH_STORE_BYTES);
+    CHECK(BENCH_STORE_BYTES <= NVM_SIM_SEE_BYTES);
+}
+
+
+// fill a, b with n words of LCG output, and m with an odd modulus
+// above both
+static void pukccOperands(uint32_t *a, uint32_t *b, uint32_t *m, size_t n,
+        uint32_t seed)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        a[i] = seed;
+        seed = seed * 1664525 + 1013904223;
+        b[i] = seed;
+        seed = seed * 1664525 + 1013904223;
+        m[i] = seed;
+    }
+    m[0] |= 1;
+    m[n - 1] |= 0x80000000;
+    a[n - 1] &= 0x7FFFFFFF;
+    b[n - 1] &= 0x7FFFFFFF;
+}
+
+
+static void testPukcc(void)
+{
+    static uint32_t a[PUKCC_MAX_LIMBS];
+    static uint32_t b[PUKCC_MAX_LIMBS];
+    static uint32_t m[PUKCC_MAX_LIMBS];
+    static uint32_t r[2 * PUKCC_MAX_LIMBS];
+    static uint32_t expected[2 * PUKCC_MAX_LIMBS];
+
+    // multN: the schoolbook model alone, and Karatsuba down to it
+    pukccOperands(a, b, m, 37, 1);
+    calcExpectedMultN(expected, a, b, 37);
+    static uint32_t scratch[5 * PUKCC_MAX_LIMBS];
+    multNKaratsuba(r, a, b, 37, NULL, 38);
+    CHECK(memcmp(r, expected, 2 * 37 * 4) == 0);
+    multNKaratsuba(r, a, b, 37, scratch, 4);
+    CHECK(memcmp(r, expected, 2 * 37 * 4) == 0);
+
+    // no words: nothing checked, and nothing read
+    int32_t passCount = 1;
+    int32_t failCount = 1;
+    testAsmMultN(0, "", NULL, NULL, NULL, 0, &passCount, &failCount, false, &txComplete);
+    CHECK(passCount == 0 && failCount == 0);
+    passCount = failCount = 1;
+    testPukccModMult(0, "", NULL, NULL, NULL, NULL, 0, &passCount, &failCount, false,
+            &txComplete);
+    CHECK(passCount == 0 && failCount == 0);
+    CHECK(multNKaratsubaScratchLimbs(PUKCC_MAX_LIMBS, 2) <= 5 * PUKCC_MAX_LIMBS);
+
+    // the size threshold: one word under it is software, at it the PUKCC
+    pukccSimReset();
+    CHECK(pukccInit() == true && pukccAvailable());
+    CHECK(pukccVersion == PUKCC_SIM_VERSION);
+    CHECK(pukccMinLimbs == PUKCC_DEFAULT_MIN_LIMBS);
+    uint32_t errorsBefore = pukccErrors;
+    size_t sizes[] = { 1, PUKCC_DEFAULT_MIN_LIMBS - 1, PUKCC_DEFAULT_MIN_LIMBS,
+            33, PUKCC_MAX_LIMBS };
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t n = sizes[s];
+        pukccPath want = (n >= PUKCC_DEFAULT_MIN_LIMBS) ? PUKCC_PATH_HW : PUKCC_PATH_SW;
+        uint32_t calls = pukccSimCalls;
+        pukccOperands(a, b, m, n, 100 + s);
+        calcExpectedMultN(expected, a, b, n);
+        CHECK(pukccMultN(r, a, b, n) == want);
+        CHECK(memcmp(r, expected, 2 * n * 4) == 0);
+        CHECK(pukccSimCalls - calls == ((want == PUKCC_PATH_HW) ? 1U : 0U));
+        if (n <= MULTN_MAX_TEST_LIMBS)
+        {
+            calcExpectedModMultN(expected, a, b, m, n);
+            CHECK(pukccModMultN(r, a, b, m, n) == want);
+            CHECK(memcmp(r, expected, n * 4) == 0);
+        }
+    }
+    CHECK(pukccErrors == errorsBefore);
+
+    // the product and both Barrett multiplies go to the PUKCC
+    uint32_t calls = pukccSimCalls;
+    pukccOperands(a, b, m, 16, 150);
+    CHECK(pukccModMultN(r, a, b, m, 16) == PUKCC_PATH_HW);
+    CHECK(pukccSimCalls - calls == 3);
+
+    // moduli the Barrett setup has to cope with: leading zero words and
+    // a small top word (its Barrett multiplies are under the threshold,
+    // so it isn't all PUKCC), one word, and an exact power of 2^32
+    pukccOperands(a, b, m, 16, 160);
+    for (size_t i = 10; i < 16; ++i)
+    {
+        a[i] = b[i] = m[i] = 0;
+    }
+    m[9] = 0x1234;
+    a[9] = 0x1233;
+    b[9] = 0x0FFF;
+    calcExpectedModMultN(expected, a, b, m, 16);
+    CHECK(pukccModMultN(r, a, b, m, 16) == PUKCC_PATH_SW);
+    CHECK(memcmp(r, expected, 16 * 4) == 0);
+    CHECK(pukccModMultN(r, a, b, m, 16) == PUKCC_PATH_SW);  // mu kept
+    CHECK(memcmp(r, expected, 16 * 4) == 0);
+    a[0] = 0xFFFFFFFE;
+    b[0] = 0x12345678;
+    m[0] = 0xFFFFFFFF;
+    calcExpectedModMultN(expected, a, b, m, 1);
+    CHECK(pukccModMultN(r, a, b, m, 1) == PUKCC_PATH_SW);
+    CHECK(r[0] == expected[0]);
+    pukccOperands(a, b, m, 3, 170);
+    a[2] = b[2] = 0;
+    m[0] = m[1] = 0;
+    m[2] = 1;
+    calcExpectedModMultN(expected, a, b, m, 3);
+    CHECK(pukccModMultN(r, a, b, m, 3) == PUKCC_PATH_SW);
+    CHECK(memcmp(r, expected, 3 * 4) == 0);
+
+    pukccMinLimbs = 4;
+    pukccOperands(a, b, m, 4, 7);
+    CHECK(pukccMultN(r, a, b, 4) == PUKCC_PATH_HW);
+    pukccMinLimbs = PUKCC_DEFAULT_MIN_LIMBS;
+
+    // Fmult reports an error: counted, and redone in software
+    pukccSimFailFmult = true;
+    pukccOperands(a, b, m, 32, 200);
+    calcExpectedMultN(expected, a, b, 32);
+    CHECK(pukccMultN(r, a, b, 32) == PUKCC_PATH_SW);
+    CHECK(memcmp(r, expected, 2 * 32 * 4) == 0);
+    CHECK(pukccErrors == errorsBefore + 1);
+    pukccSimFailFmult = false;
+
+    // the self test fails: the PUKCC is never called again
+    pukccSimReset();
+    pukccSimFailSelfTest = true;
+    CHECK(pukccInit() == false && !pukccAvailable());
+    CHECK(pukccSimCalls == 1);
+    pukccOperands(a, b, m, 64, 300);
+    calcExpectedMultN(expected, a, b, 64);
+    CHECK(pukccMultN(r, a, b, 64) == PUKCC_PATH_SW);
+    CHECK(memcmp(r, expected, 2 * 64 * 4) == 0);
+    calcExpectedModMultN(expected, a, b, m, 64);
+    CHECK(pukccModMultN(r, a, b, m, 64) == PUKCC_PATH_SW);
+    CHECK(memcmp(r, expected, 64 * 4) == 0);
+    CHECK(pukccSimCalls == 1);
+
+    // bad arguments: nothing computed, the PUKCC never called
+    pukccSimReset();
+    pukccInit();
+    calls = pukccSimCalls;
+    r[0] = 0x12345678;
+    CHECK(pukccMultN(r, a, b, 0) == PUKCC_PATH_ERROR);
+    CHECK(pukccMultN(r, a, b, PUKCC_MAX_LIMBS + 1) == PUKCC_PATH_ERROR);
+    CHECK(pukccModMultN(r, a, b, m, 0) == PUKCC_PATH_ERROR);
+    CHECK(pukccModMultN(r, a, b, m, PUKCC_MAX_LIMBS + 1) == PUKCC_PATH_ERROR);
+    memset(m, 0, sizeof(m));
+    CHECK(pukccModMultN(r, a, b, m, 16) == PUKCC_PATH_ERROR);
+    CHECK(r[0] == 0x12345678);
+    CHECK(pukccSimCalls == calls);
+}
+
+
+static void testFir(void)
+{
+    static int16_t h[33];
+    static int16_t in[FIR_MAX_TEST_VALS];
+    static int16_t out[FIR_MAX_TEST_VALS];
+    static int16_t expected[FIR_MAX_TEST_VALS];
+    static uint32_t coefBuf[FIR_COEF_WORDS(33)];
+    static uint32_t stateBuf[FIR_STATE_WORDS(33)];
+    firFilter f;
+
+    uint32_t seed = 0x0F1F0F1F;
+    for (uint32_t i = 0; i < FIR_MAX_TEST_VALS; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        in[i] = (int16_t)(seed >> 16);
+    }
+    // sum of |h| under 2.0, so the 32 bit sum can't overflow
+    for (uint32_t k = 0; k < 33; ++k)
+    {
+        seed = seed * 1664525 + 1013904223;
+        h[k] = (int16_t)(seed >> 16) / 33;
+    }
+
+    CHECK(firInit(&f, h, 0, coefBuf, stateBuf) == false);
+
+    // odd and even tap counts (33 is padded to 34), one sample at a
+    // time, and blocks that end part way round the circular buffer
+    static const uint32_t taps[] = { 1, 2, 8, 33 };
+    static const uint32_t blocks[] = { 1, 5, 7, 34, FIR_MAX_TEST_VALS };
+    for (uint32_t t = 0; t < sizeof(taps) / sizeof(taps[0]); ++t)
+    {
+        calcExpectedFir(h, taps[t], in, expected, FIR_MAX_TEST_VALS);
+        for (uint32_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); ++b)
+        {
+            CHECK(firInit(&f, h, taps[t], coefBuf, stateBuf));
+            for (uint32_t i = 0; i < FIR_MAX_TEST_VALS; i += blocks[b])
+            {
+                uint32_t n = FIR_MAX_TEST_VALS - i;
+                firProcess(&f, &in[i], &out[i], (n < blocks[b]) ? n : blocks[b]);
+            }
+            CHECK(memcmp(out, expected, sizeof(out)) == 0);
+        }
+    }
+    CHECK(f.numTaps == 34 && f.pos == FIR_MAX_TEST_VALS % 34);
+
+    // in place, and a reset clears the history but keeps the taps
+    static int16_t buf[FIR_MAX_TEST_VALS];
+    memcpy(buf, in, sizeof(buf));
+    firReset(&f);
+    firProcess(&f, buf, buf, FIR_MAX_TEST_VALS);
+    CHECK(memcmp(buf, expected, sizeof(buf)) == 0);
+
+    // and testFirFilter agrees, and notices a wrong sample
+    int32_t passCount = 0;
+    int32_t failCount = 0;
+    testFirFilter(0, "firProcess", h, 33, 7, in, out, FIR_MAX_TEST_VALS,
+            &passCount, &failCount, true, &txComplete);
+    CHECK(failCount == 0 && passCount > 0);
+    out[100] ^= 1;
+    hostQuiet = true;
+    testFirFilter(0, "firProcess", h, 33, 7, in, out, FIR_MAX_TEST_VALS,
+            &passCount, &failCount, true, &txComplete);
+    hostQuiet = false;
+    CHECK(failCount == 1);
+
+    // an empty stream: nothing checked, and nothing read
+    passCount = failCount = 1;
+    testFirFilter(0, "", h, 33, 7, NULL, NULL, 0, &passCount, &failCount, false,
+            &txComplete);
+    CHECK(passCount == 0 && failCount == 0);
+}
+
+
+int main(void)
+{
+    testCalcExpectedValues();
+    testRunnerWithRefKernels();
+    testRunnerCatchesBadKernel();
+    testRunnerOwnCases();
+    testRandomAndSweep();
+    testOtherRefs();
+    testBenchStore();
+    testPukcc();
+    testFir();
+
+    printf("%d checks, %d failed\n", checksRun, checksFailed);
+    return checksFailed;
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,100 @@
+/* ************************************************************************** */
+/** Host model of the TRNG
+
+  @File Name
+    trngSim.c
+
+  @Summary
+    Register model behind TRNG_REGS for off-target builds of plib_trng.c.
+
+  @Description
+    Only what plib_trng.c uses is modeled: CTRLA.ENABLE, the DATARDY
+    interrupt mask (INTENSET/INTENCLR share it, as on the chip), INTFLAG
+    and DATA. The DATA words are an LCG seeded by trngSimReset, not
+    random numbers. Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifdef TRNG_HOST_SIM
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "device.h"
+#include "peripheral/trng/plib_trng.h"
+#include "trngSim.h"
+
+// DATA (offset 0x20) is read-only in trng_registers_t, so the model
+// writes it through this view of the same memory
+typedef union
+{
+    trng_registers_t regs;
+    uint8_t bytes[sizeof(trng_registers_t)];
+} trngSimMem;
+
+static trngSimMem sim;
+static uint8_t intMask = 0;   // the DATARDY mask behind INTENSET/INTENCLR
+static uint32_t lcg = 1;
+
+uint32_t trngSimWords = 0;
+uint32_t trngSimInterrupts = 0;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+trng_registers_t *trngSimRegs(void)
+{
+    // apply the mask writes the plib made since the last access
+    intMask |= sim.regs.TRNG_INTENSET;
+    intMask &= (uint8_t)~sim.regs.TRNG_INTENCLR;
+    sim.regs.TRNG_INTENCLR = 0;
+    sim.regs.TRNG_INTENSET = intMask;
+
+    if ((sim.regs.TRNG_CTRLA & TRNG_CTRLA_ENABLE_Msk) != 0U)
+    {
+        uint32_t data;
+
+        lcg = lcg * 1664525UL + 1013904223UL;
+        data = lcg;
+        memcpy(&sim.bytes[offsetof(trng_registers_t, TRNG_DATA)], &data, sizeof(data));
+        sim.regs.TRNG_INTFLAG |= (uint8_t)TRNG_INTFLAG_DATARDY_Msk;
+        trngSimWords += 1;
+    }
+    return &sim.regs;
+}
+
+
+bool trngSimRun(void)
+{
+    trng_registers_t *regs = trngSimRegs();
+
+    if (((regs->TRNG_CTRLA & TRNG_CTRLA_ENABLE_Msk) == 0U)
+            || ((intMask & TRNG_INTENSET_DATARDY_Msk) == 0U))
+    {
+        return false;
+    }
+    trngSimInterrupts += 1;
+    TRNG_InterruptHandler();
+    return true;
+}
+
+
+void trngSimReset(uint32_t seed)
+{
+    memset(&sim, 0, sizeof(sim));
+    intMask = 0;
+    lcg = seed;
+    trngSimWords = 0;
+    trngSimInterrupts = 0;
+}
+
+#endif /* TRNG_HOST_SIM */
+
+/* *****************************************************************************
+ End of File
+ */
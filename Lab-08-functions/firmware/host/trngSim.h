@@ -0,0 +1,62 @@
+/* ************************************************************************** */
+/** Host model of the TRNG
+
+  @File Name
+    trngSim.h
+
+  @Summary
+    Stands in for the TRNG registers when plib_trng.c is built on a PC
+    with TRNG_HOST_SIM defined.
+
+  @Description
+    TRNG_REGS becomes a call to trngSimRegs(), so every register access
+    in the plib also steps the model: while CTRLA.ENABLE is set, each
+    access makes a new DATA word ready. The words come from a seeded
+    generator, so a host run gives the same numbers every time.
+    trngSimRun() plays the part of the NVIC for the interrupt mode.
+    Not built for the target.
+ */
+/* ************************************************************************** */
+
+#ifndef _TRNG_SIM_H    /* Guard against multiple inclusion */
+#define _TRNG_SIM_H
+
+#ifdef TRNG_HOST_SIM
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "device.h"
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#undef TRNG_REGS
+#define TRNG_REGS (trngSimRegs())
+
+extern uint32_t trngSimWords;        // DATA words made ready so far
+extern uint32_t trngSimInterrupts;   // TRNG_InterruptHandler calls by trngSimRun
+
+// step the model and return its registers
+trng_registers_t *trngSimRegs(void);
+
+// call TRNG_InterruptHandler if the TRNG is enabled with DATARDY
+// unmasked, like the NVIC would. Returns true if it was called.
+bool trngSimRun(void);
+
+// disable the model, clear the counters and seed the DATA sequence
+void trngSimReset(uint32_t seed);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRNG_HOST_SIM */
+
+#endif /* _TRNG_SIM_H */
+
+/* *****************************************************************************
+ End of File
+ */
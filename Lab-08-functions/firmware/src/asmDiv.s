@@ -0,0 +1,175 @@
+/*** asmDiv.s   ***/
+/* Divide functions to go with the multiplies in asmMult.s.
+ * asmDiv..asmUDivMod use the Cortex-M4 SDIV/UDIV instructions.
+ * asmUDivConst divides by a divisor that is known ahead of time with a
+ * multiply and shifts; divConst.c computes its magic numbers.
+ * testFuncs.c has the C reference model for all of these.
+ *
+ * Divide by 0 does not trap (CCR.DIV_0_TRP is left at 0): the quotient
+ * is 0 and the remainder is the dividend.
+ */
+
+/* Tell the assembler to allow both 16b and 32b extended Thumb instructions */
+.syntax unified
+
+#include <xc.h>
+
+ /* Tell the assembler that what follows is in instruction memory    */
+.text
+.align
+
+.global asmDiv, asmMod, asmDivMod, asmUDiv, asmUMod, asmUDivMod
+.type asmDiv,%function
+.type asmMod,%function
+.type asmDivMod,%function
+.type asmUDiv,%function
+.type asmUMod,%function
+.type asmUDivMod,%function
+
+.global asmUDivConst, asmUDivConstN
+.type asmUDivConst,%function
+.type asmUDivConstN,%function
+
+/* function: asmDiv
+ *    inputs:   r0: signed dividend n
+ *              r1: signed divisor d
+ *    outputs:  r0: n / d, rounded toward 0 like C.
+ *                  INT32_MIN / -1 gives INT32_MIN, n / 0 gives 0
+ */
+asmDiv:
+    /* int32 q = asmDiv(int32 n, int32 d) */
+    /*      R0             R0       R1  */
+    SDIV R0,R0,R1     // q = n / d
+    BX LR             // return to caller
+/***************  END ---- asmDiv  ************/
+
+
+/* function: asmMod
+ *    inputs:   r0: signed dividend n
+ *              r1: signed divisor d
+ *    outputs:  r0: n % d; same sign as n, like C. n % 0 gives n
+ */
+asmMod:
+    /* int32 r = asmMod(int32 n, int32 d) */
+    /*      R0             R0       R1  */
+    SDIV R2,R0,R1     // q = n / d
+    MLS R0,R2,R1,R0   // r = n - q*d
+    BX LR             // return to caller
+/***************  END ---- asmMod  ************/
+
+
+/* function: asmDivMod
+ *    inputs:   r0: signed dividend n
+ *              r1: signed divisor d
+ *              r2: address where to store n % d
+ *    outputs:  r0: n / d
+ *              memory: n % d stored at the address in r2
+ */
+asmDivMod:
+    /* int32 q = asmDivMod(int32 n, int32 d, int32 *rem) */
+    /*      R0                R0       R1            R2   */
+    SDIV R3,R0,R1     // q = n / d
+    MLS R0,R3,R1,R0   // r = n - q*d
+    STR R0,[R2]       // *rem = r
+    MOV R0,R3         // return q
+    BX LR             // return to caller
+/***************  END ---- asmDivMod  ************/
+
+
+/* function: asmUDiv
+ *    inputs:   r0: unsigned dividend n
+ *              r1: unsigned divisor d
+ *    outputs:  r0: n / d. n / 0 gives 0
+ */
+asmUDiv:
+    /* uint32 q = asmUDiv(uint32 n, uint32 d) */
+    /*       R0                R0        R1  */
+    UDIV R0,R0,R1     // q = n / d
+    BX LR             // return to caller
+/***************  END ---- asmUDiv  ************/
+
+
+/* function: asmUMod
+ *    inputs:   r0: unsigned dividend n
+ *              r1: unsigned divisor d
+ *    outputs:  r0: n % d. n % 0 gives n
+ */
+asmUMod:
+    /* uint32 r = asmUMod(uint32 n, uint32 d) */
+    /*       R0                R0        R1  */
+    UDIV R2,R0,R1     // q = n / d
+    MLS R0,R2,R1,R0   // r = n - q*d
+    BX LR             // return to caller
+/***************  END ---- asmUMod  ************/
+
+
+/* function: asmUDivMod
+ *    inputs:   r0: unsigned dividend n
+ *              r1: unsigned divisor d
+ *              r2: address where to store n % d
+ *    outputs:  r0: n / d
+ *              memory: n % d stored at the address in r2
+ */
+asmUDivMod:
+    /* uint32 q = asmUDivMod(uint32 n, uint32 d, uint32 *rem) */
+    /*       R0                   R0        R1             R2   */
+    UDIV R3,R0,R1     // q = n / d
+    MLS R0,R3,R1,R0   // r = n - q*d
+    STR R0,[R2]       // *rem = r
+    MOV R0,R3         // return q
+    BX LR             // return to caller
+/***************  END ---- asmUDivMod  ************/
+
+
+/* function: asmUDivConst
+ *    inputs:   r0: unsigned dividend n
+ *              r1: address of the divMagic struct for divisor d
+ *                  (divConst.h): magic, shift1, shift2, divisor
+ *    outputs:  r0: n / d
+ *    NOTE: t = (n * magic) >> 32
+ *          q = (t + ((n - t) >> shift1)) >> shift2
+ *          Works for every d >= 1 without a 33 bit magic number or
+ *          a branch (Granlund & Montgomery). No divide instruction,
+ *          so the time does not depend on n.
+ */
+asmUDivConst:
+    /* uint32 q = asmUDivConst(uint32 n, const divMagic *m) */
+    /*       R0                     R0                   R1  */
+    LDM R1,{R1-R3}    // r1 = magic, r2 = shift1, r3 = shift2
+    UMULL R12,R1,R0,R1 // r1 = t, high word of n * magic
+    SUB R0,R0,R1      // n - t, can't underflow: t <= n
+    LSR R0,R0,R2      // (n - t) >> shift1
+    ADD R0,R0,R1      // + t
+    LSR R0,R0,R3      // >> shift2
+    BX LR             // return to caller
+/***************  END ---- asmUDivConst  ************/
+
+
+/* function: asmUDivConstN
+ *    inputs:   r0: address of the array of dividends
+ *              r1: address of the array for the quotients
+ *              r2: number of values (n)
+ *              r3: address of the divMagic struct for divisor d
+ *    outputs:  r0: No return value
+ *              memory: out[i] = in[i] / d
+ *    NOTE: same math as asmUDivConst with the magic numbers loaded once
+ */
+asmUDivConstN:
+    /* void asmUDivConstN(const uint32_t *in, uint32_t *out, size_t n, const divMagic *m) */
+    /*                                    R0            R1         R2                  R3  */
+    PUSH {r4-r7}      // save the callee-saved regs used by the loop
+    CBZ R2,2f         // nothing to do for n == 0
+    LDM R3,{R3-R5}    // r3 = magic, r4 = shift1, r5 = shift2
+1:  LDR R6,[R0],4     // in[i]
+    UMULL R7,R12,R6,R3 // r12 = t, high word of in[i] * magic
+    SUB R6,R6,R12     // n - t
+    LSR R6,R6,R4      // >> shift1
+    ADD R6,R6,R12     // + t
+    LSR R6,R6,R5      // >> shift2
+    STR R6,[R1],4     // out[i]
+    SUBS R2,R2,1
+    BNE 1b
+2:  POP {r4-r7}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmUDivConstN  ************/
+.end   /* the assembler will ignore anything after this line. */
@@ -19,6 +19,7 @@
 #define _EXAMPLE_FILE_NAME_H
 
 #include "definitions.h"                // SYS function prototypes
+#include "divConst.h"                   // divMagic for asmUDivConst
 
 extern uint32_t nameStrPtr;
 
@@ -33,6 +34,21 @@ extern int32_t b_Abs;
 extern int32_t init_Product;
 extern int32_t final_Product;
 
+/* intermediate values of one asmMainCtx call. Same meaning as the
+ * globals above. asmMainCtx stores all 8 fields with one STM, so don't
+ * reorder or add fields without changing asmMult.s too. */
+typedef struct _mult_ctx_t
+{
+    int32_t a_Multiplicand;
+    int32_t b_Multiplier;
+    int32_t a_Sign;
+    int32_t b_Sign;
+    int32_t a_Abs;
+    int32_t b_Abs;
+    int32_t init_Product;
+    int32_t final_Product;
+} mult_ctx_t;
+
 
 /* Provide C++ Compatibility */
 #ifdef __cplusplus
@@ -43,6 +59,72 @@ extern "C" {
      * to a known value */
     void asmExternsInit(void);
 
+    /* asmAbs on both halves of a packed value at once. Returns/stores
+     * abs(a) in the top 16 bits and abs(b) in the bottom 16 bits;
+     * sign bits: bit 1 = sign of a, bit 0 = sign of b */
+    uint32_t asmAbsPacked(uint32_t packed, uint32_t *absPacked, uint32_t *signBits);
+
+    /* the two asmMult implementations; asmMult is an alias for one of
+     * them, selected at build time (see asmMult.s) */
+    int32_t asmMultShiftAdd(int32_t a, int32_t b);
+    int32_t asmMultHw(int32_t a, int32_t b);
+
+    /* shift-and-add over the bits of the smaller operand only */
+    int32_t asmMultClz(int32_t a, int32_t b);
+
+    /* out[i] = asmMain(packed[i]) for n values, without the debug globals */
+    void asmMainBatch(const uint32_t *packed, int32_t *out, size_t n);
+
+    /* 64 bit dot product / multiply-accumulate over arrays of packed
+     * values: sum of x[i].hi*y[i].hi + x[i].lo*y[i].lo */
+    int64_t asmDot16(const uint32_t *x, const uint32_t *y, size_t n);
+    int64_t asmMac16(int64_t acc, const uint32_t *x, const uint32_t *y, size_t n);
+
+    /* reentrant asmMain: no globals. Intermediate values are stored in
+     * *ctx only if ctx is not NULL */
+    int32_t asmMainCtx(uint32_t packedValue, mult_ctx_t *ctx);
+
+    /* saturating asmMain; also sets rng_Error, prod_Is_Neg and
+     * final_Product. Limits are ASM_SAT_* in testFuncs.h/asmMult.s */
+    int32_t asmMainSat(uint32_t packedValue);
+
+    /* Q15 fixed-point functions in asmQ15.s; x, y and the results are
+     * packed pairs of Q15 values */
+    uint32_t asmQ15Mul(uint32_t x, uint32_t y);
+    int32_t asmQ15Mac(int32_t acc, uint32_t x, uint32_t y);
+    uint32_t asmQ15Add(uint32_t x, uint32_t y);
+    uint32_t asmQ15Sub(uint32_t x, uint32_t y);
+    uint32_t asmQ15Scale(uint32_t x, int32_t gain);
+
+    /* complex Q15 multiply over arrays; each word is one complex value,
+     * imaginary part in the top 16 bits, real part in the bottom 16 */
+    void asmCmul(const uint32_t *x, const uint32_t *y, uint32_t *out, size_t n);
+    void asmCmulConj(const uint32_t *x, const uint32_t *y, uint32_t *out, size_t n);
+
+    /* multi-precision schoolbook multiply: r[0..2n) = a[0..n) * b[0..n),
+     * little-endian 32 bit words; r must not overlap a or b.
+     * multN.h has the Karatsuba driver for large n */
+    void asmMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+    /* divide functions in asmDiv.s, SDIV/UDIV based. Like C, quotients
+     * round toward 0 and remainders have the sign of n. Divide by 0
+     * gives a quotient of 0 and a remainder of n */
+    int32_t asmDiv(int32_t n, int32_t d);
+    int32_t asmMod(int32_t n, int32_t d);
+    int32_t asmDivMod(int32_t n, int32_t d, int32_t *rem);
+    uint32_t asmUDiv(uint32_t n, uint32_t d);
+    uint32_t asmUMod(uint32_t n, uint32_t d);
+    uint32_t asmUDivMod(uint32_t n, uint32_t d, uint32_t *rem);
+
+    /* n / d with no divide instruction, using magic numbers from
+     * divMagicInit (divConst.h) */
+    uint32_t asmUDivConst(uint32_t n, const divMagic *m);
+    void asmUDivConstN(const uint32_t *in, uint32_t *out, size_t n, const divMagic *m);
+
+    /* quarter-squares table multiply in asmQsq.s; a and b must be
+     * 0 .. 2^QSQ_OPERAND_BITS - 1 (testFuncs.h) */
+    int32_t asmMultQsq(int32_t a, int32_t b);
+
 
     /* Provide C++ Compatibility */
 #ifdef __cplusplus
@@ -0,0 +1,66 @@
+/*** asmFir.s   ***/
+/* Block FIR filter kernel for firFilter.c. One call filters a whole
+ * block of int16 samples, so there is no per-sample call overhead.
+ * The inner loop is one SMLAD per pair of taps: the same dual 16 bit
+ * multiply that the packed a/b format in asmMult.s is built around.
+ */
+
+/* Tell the assembler to allow both 16b and 32b extended Thumb instructions */
+.syntax unified
+
+#include <xc.h>
+
+ /* Tell the assembler that what follows is in instruction memory    */
+.text
+.align
+
+.global asmFirBlock
+.type asmFirBlock,%function
+
+/* function: asmFirBlock
+ *    inputs:   r0: address of the input samples (int16)
+ *              r1: address for the output samples (int16)
+ *              r2: number of samples (n)
+ *              r3: address of a firFilter struct (firFilter.h):
+ *                  state, coefs, numTaps, pos
+ *    outputs:  r0: No return value
+ *              memory: out[i] = sum of h[k] * x[i-k], Q15, rounded down
+ *                      and saturated; f->pos and f->state updated
+ *    NOTE: the state is a circular buffer of numTaps samples stored
+ *          twice (state[i] == state[i + numTaps]), so the last numTaps
+ *          samples are always one contiguous run starting at
+ *          state[pos]. coefs holds the taps reversed to match that run.
+ *          numTaps is even. When pos is odd the sample pairs are
+ *          unaligned word loads, which the M4 allows for LDR.
+ */
+asmFirBlock:
+    /* void asmFirBlock(const int16_t *in, int16_t *out, size_t n, firFilter *f) */
+    /*                                 R0           R1         R2            R3  */
+    PUSH {r4-r11,lr}  // save the callee-saved regs used by the loops
+    CBZ R2,3f         // nothing to do for n == 0
+    LDM R3,{R4-R7}    // r4 = state, r5 = coefs, r6 = numTaps, r7 = pos
+1:  LDRH R8,[R0],2    // next input sample
+    ADD R9,R4,R7,LSL 1
+    STRH R8,[R9]      // replaces the oldest sample, in both copies
+    STRH R8,[R9,R6,LSL 1]
+    ADD R7,R7,1       // pos = (pos + 1) % numTaps
+    CMP R7,R6
+    MOVEQ R7,0
+    ADD R9,R4,R7,LSL 1 // r9 -> oldest sample of the window
+    MOV R10,R5        // r10 -> coefs
+    MOV R11,0         // r11 = accumulator
+    LSR R12,R6,1      // r12 = pairs of taps
+2:  LDR R8,[R9],4     // two samples
+    LDR LR,[R10],4    // two coefficients
+    SMLAD R11,R8,LR,R11 // acc += x0*h0 + x1*h1
+    SUBS R12,R12,1
+    BNE 2b
+    SSAT R11,16,R11,ASR 15 // Q30 -> Q15, saturated
+    STRH R11,[R1],2   // out[i]
+    SUBS R2,R2,1
+    BNE 1b
+    STR R7,[R3,12]    // f->pos
+3:  POP {r4-r11,lr}   // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmFirBlock  ************/
+.end   /* the assembler will ignore anything after this line. */
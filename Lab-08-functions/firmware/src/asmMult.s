@@ -53,16 +53,43 @@ b_Abs:           .word     0
 init_Product:    .word     0
 final_Product:   .word     0
 
+/* Saturation limits for asmMainSat, in bits of a signed (two's
+ * complement) value. Override with assembler symbols, e.g.
+ * -Wa,--defsym=ASM_SAT_BITS=24. testFuncs.h has the C copies of these,
+ * keep them in sync.
+ *   ASM_SAT_OPERAND_BITS: range of a and b. 16 = any int16 is OK
+ *   ASM_SAT_BITS:         range of the product. 31 = Q15 * Q15 -> Q30,
+ *                         where only -1.0 * -1.0 (0x8000 * 0x8000)
+ *                         saturates */
+.ifndef ASM_SAT_OPERAND_BITS
+.equ ASM_SAT_OPERAND_BITS, 16
+.endif
+.ifndef ASM_SAT_BITS
+.equ ASM_SAT_BITS, 31
+.endif
+
  /* Tell the assembler that what follows is in instruction memory    */
 .text
 .align
 
 .global asmUnpack, asmAbs, asmMult, asmFixSign, asmMain
+.global asmAbsPacked
+.global asmMultShiftAdd, asmMultHw, asmMultClz, asmMainBatch
+.global asmDot16, asmMac16, asmMainCtx, asmMainSat, asmMultN
 .type asmUnpack,%function
 .type asmAbs,%function
-.type asmMult,%function
+.type asmAbsPacked,%function
+.type asmMultShiftAdd,%function
+.type asmMultHw,%function
+.type asmMultClz,%function
 .type asmFixSign,%function
 .type asmMain,%function
+.type asmMainBatch,%function
+.type asmDot16,%function
+.type asmMac16,%function
+.type asmMainCtx,%function
+.type asmMainSat,%function
+.type asmMultN,%function
 
 /* function: asmUnpack
  *    inputs:   r0: contains the packed value. 
@@ -118,13 +145,59 @@ asmAbs:
 /*** STUDENTS: Place your asmAbs code ABOVE this line!!! **************/
 /***************  END ---- asmAbs  ************/
 
+
+/* function: asmAbsPacked
+ *    inputs:   r0: contains packed value, same format as asmUnpack input
+ *              r1: address where to store the packed absolute values
+ *              r2: address where to store the sign bits
+ *    outputs:  r0: packed absolute values. Same value as stored to
+ *                  location given in r1:
+ *                  MSB 16bits = abs(a), LSB 16bits = abs(b), unsigned
+ *                  (so 0x8000 = -32768 gives 0x8000 = 32768)
+ *              memory: store packed abs values in location given by r1
+ *                      store sign bits in location given by r2:
+ *                      bit 1 = sign of a, bit 0 = sign of b
+ *    NOTE: does both halves of asmAbs in one call. No branches and no
+ *          conditional instructions, so it always takes the same time.
+ */    
+asmAbsPacked:  
+    /* uint abs = asmAbsPacked(uint packed, uint* absPacked, uint* signBits); */
+    /*      R0                       R0           R1               R2       */
+    LSR R3,R0,31      // sign of a = bit 31
+    UBFX R12,R0,15,1  // sign of b = bit 15
+    ORR R3,R12,R3,LSL 1 // sign bits: a in bit 1, b in bit 0
+    STR R3,[R2]       // save sign bits to addr(signBits)
+    MOV R3,0
+    SSUB16 R12,R3,R0  // both halves: 0 - x. GE bits set for halves where x <= 0
+    SEL R0,R12,R0     // per half: GE ? -x : x
+    STR R0,[R1]       // save packed abs values to addr(absPacked)
+    BX LR             // return to caller
+/***************  END ---- asmAbsPacked  ************/
+
  
 /* function: asmMult
  *    inputs:   r0: contains abs value of multiplicand (a)
  *              r1: contains abs value of multiplier (b)
  *    outputs:  r0: initial product: r0 * r1
+ *    NOTE: asmMult is an alias, picked at build time, for one of the
+ *          two implementations below:
+ *            asmMultHw       - single MUL instruction (default)
+ *            asmMultShiftAdd - shift-and-add reference loop
+ *          To link the shift-and-add version, define the assembler
+ *          symbol ASM_MULT_SHIFT_ADD (Project Properties -> xc32-as ->
+ *          Assembler symbols, i.e. -Wa,--defsym=ASM_MULT_SHIFT_ADD=1).
+ *          Both are always exported so benchFuncs.c can compare them.
  */ 
-asmMult:   
+.ifdef ASM_MULT_SHIFT_ADD
+.thumb_set asmMult, asmMultShiftAdd
+.else
+.thumb_set asmMult, asmMultHw
+.endif
+
+/* function: asmMultShiftAdd
+ *    same inputs and outputs as asmMult
+ */ 
+asmMultShiftAdd:   
 /*** STUDENTS: Place your asmMult code BELOW this line!!! **************/
     /*   uint product = asmMult(uint a, uint b); */
     /*          R0                 R0    R1      */
@@ -140,7 +213,53 @@ asmMult:
     POP  {r4-r11,LR}  // restore caller registers
     BX LR             // return to caller
 /*** STUDENTS: Place your asmMult code ABOVE this line!!! **************/
-/***************  END ---- asmMult  ************/
+/***************  END ---- asmMultShiftAdd  ************/
+
+
+/* function: asmMultHw
+ *    same inputs and outputs as asmMult
+ *    Leaf function that only touches r0/r1, so nothing needs saving.
+ *    Inputs are <= 2^16, so the low 32 bits from MUL are the full
+ *    product (2^16 * 2^16 wraps to 0, same as the shift-and-add loop).
+ */ 
+asmMultHw:   
+    /*   uint product = asmMultHw(uint a, uint b); */
+    /*          R0                   R0    R1      */
+    MUL R0,R0,R1      // product = a * b, single cycle on the M4
+    BX LR             // return to caller
+/***************  END ---- asmMultHw  ************/
+
+
+/* function: asmMultClz
+ *    same inputs and outputs as asmMult
+ *    Shift-and-add like asmMultShiftAdd, but:
+ *      1) the operands are swapped if needed so the loop walks the
+ *         bits of the SMALLER one, and
+ *      2) CLZ gives that operand's bit length up front, so the loop
+ *         runs exactly that many times (MSB first) and then stops.
+ *    So 3 * 0xFFFF loops twice instead of 16 times. Leaf function
+ *    that only uses r0-r3, so nothing needs saving.
+ */ 
+asmMultClz:   
+    /*   uint product = asmMultClz(uint a, uint b); */
+    /*          R0                    R0    R1      */
+    CMP R0,R1         // make r0 the smaller operand
+    MOVHI R2,R0       // if a > b swap them
+    MOVHI R0,R1
+    MOVHI R1,R2
+    MOV R3,0          // initialize product accumulator
+    CBZ R0,2f         // smaller operand is 0: so is the product
+    CLZ R2,R0         // count leading zeros of the smaller operand
+    LSL R0,R0,R2      // move its top set bit to bit 31
+    RSB R2,R2,32      // loop count = its bit length
+1:  LSL R3,R3,1       // double the accumulator
+    LSLS R0,R0,1      // C = next bit of the smaller operand
+    ADDCS R3,R3,R1    // if set, add the larger operand
+    SUBS R2,R2,1      // one less bit to go
+    BNE 1b            // loop until every bit is done
+2:  MOV R0,R3         // move product to result=R0
+    BX LR             // return to caller
+/***************  END ---- asmMultClz  ************/
 
     
 /* function: asmFixSign
@@ -241,4 +360,223 @@ asmMain:
     BX LR             // return to caller    
 /*** STUDENTS: Place your asmMain code ABOVE this line!!! **************/
 /***************  END ---- asmMain  ************/
+
+
+/* function: asmMainBatch
+ *    inputs:   r0: address of an array of packed values, same format
+ *                  as the asmMain input (MSB 16bits a, LSB 16bits b)
+ *              r1: address of an int32 array for the products
+ *              r2: number of packed values (n)
+ *    outputs:  r0: No return value
+ *              memory: out[i] = a[i] * b[i], same value asmMain returns
+ *    NOTE: does not touch the debug globals (a_Multiplicand etc.).
+ *          SMULTB multiplies the signed top half by the signed bottom
+ *          half directly, so no unpack/abs/fix-sign steps are needed.
+ *          Main loop does 4 values per pass with LDM/STM.
+ */  
+asmMainBatch:   
+    /* void asmMainBatch(const uint32_t *packed, int32_t *out, size_t n) */
+    /*                                   R0              R1         R2   */
+    PUSH {r4-r6}      // save the callee-saved regs used by the loop
+    SUBS R2,R2,4      // any full groups of 4?
+    BLO 2f            // no: go do the leftovers
+1:  LDM R0!,{R3-R6}   // load 4 packed values
+    SMULTB R3,R3,R3   // out = a (top half) * b (bottom half)
+    SMULTB R4,R4,R4
+    SMULTB R5,R5,R5
+    SMULTB R6,R6,R6
+    STM R1!,{R3-R6}   // store 4 products
+    SUBS R2,R2,4      // count down by 4
+    BHS 1b            // loop while at least 4 remain
+2:  ADDS R2,R2,4      // 0..3 values left over
+    BEQ 4f
+3:  LDR R3,[R0],4     // load 1 packed value
+    SMULTB R3,R3,R3   // out = a * b
+    STR R3,[R1],4     // store product
+    SUBS R2,R2,1
+    BNE 3b
+4:  POP {r4-r6}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmMainBatch  ************/
+
+
+/* function: asmDot16
+ *    inputs:   r0: address of array x of packed values
+ *              r1: address of array y of packed values
+ *              r2: number of packed values in each array (n)
+ *    outputs:  r0,r1: 64 bit dot product (r0 = low word, r1 = high word)
+ *                  sum of x[i].hi*y[i].hi + x[i].lo*y[i].lo
+ *    NOTE: same as asmMac16 with the accumulator starting at 0.
+ */  
+asmDot16:   
+    /* int64_t dot = asmDot16(const uint32_t *x, const uint32_t *y, size_t n) */
+    /*       R0:R1                          R0                R1        R2    */
+    PUSH {r4-r7}      // save the callee-saved regs used by the loop
+    MOV R12,R2        // n
+    MOV R2,R0         // x
+    MOV R3,R1         // y
+    MOVS R0,0         // accumulator = 0
+    MOVS R1,0
+    B .Lmac16Loop     // share the asmMac16 loop
+/***************  END ---- asmDot16  ************/
+
+
+/* function: asmMac16
+ *    inputs:   r0,r1: 64 bit accumulator (r0 = low word, r1 = high word)
+ *              r2: address of array x of packed values
+ *              r3: address of array y of packed values
+ *              [sp]: number of packed values in each array (n)
+ *    outputs:  r0,r1: accumulator plus the dot product of x and y
+ *    NOTE: SMLALD does both halfword products of a word pair and adds
+ *          them into the 64 bit accumulator in one instruction. The
+ *          32 bit SMLAD can't be used here: 0x8000*0x8000 twice is 2^31,
+ *          which already overflows a signed 32 bit sum.
+ */  
+asmMac16:   
+    /* int64_t acc = asmMac16(int64_t acc, const uint32_t *x, const uint32_t *y, size_t n) */
+    /*      R0:R1                   R0:R1                 R2                R3     [sp]   */
+    PUSH {r4-r7}      // save the callee-saved regs used by the loop
+    LDR R12,[SP,16]   // n, stacked above the 4 regs just pushed
+.Lmac16Loop:
+    SUBS R12,R12,2    // any full pairs of words?
+    BLO 2f            // no: go do the leftover
+1:  LDM R2!,{R4,R5}   // 2 words of x
+    LDM R3!,{R6,R7}   // 2 words of y
+    SMLALD R0,R1,R4,R6 // acc += x.hi*y.hi + x.lo*y.lo
+    SMLALD R0,R1,R5,R7
+    SUBS R12,R12,2    // count down by 2
+    BHS 1b            // loop while at least 2 remain
+2:  ADDS R12,R12,2    // 0 or 1 word left over
+    BEQ 3f
+    LDR R4,[R2]
+    LDR R6,[R3]
+    SMLALD R0,R1,R4,R6
+3:  POP {r4-r7}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmMac16  ************/
+
+
+
+/* function: asmMainCtx
+ *    inputs:   r0: contains packed value to be multiplied, same format
+ *                  as the asmMain input
+ *              r1: address of a caller-owned mult_ctx_t (asmExterns.h),
+ *                  or 0 (NULL) if the intermediate values aren't wanted
+ *    outputs:  r0: final product, same value asmMain returns
+ *              memory: if r1 != 0, the struct gets the same values asmMain
+ *                      stores in a_Multiplicand ... final_Product
+ *    NOTE: reentrant version of asmMain. Uses no globals, so it can run
+ *          in an ISR and the main loop at the same time.
+ *          The struct is written with one STM of r2-r9, so the field
+ *          order in mult_ctx_t must match the register order below.
+ */  
+asmMainCtx:   
+    /* int32 product = asmMainCtx(uint packedValue, mult_ctx_t *ctx) */
+    /*          R0                     R0                    R1       */
+    CBNZ R1,1f        // struct wanted? do the long version
+    SMULTB R0,R0,R0   // no: product = a (top half) * b (bottom half)
+    BX LR             // return to caller
+1:  PUSH {r4-r9}      // save the callee-saved regs used below
+    ASR R2,R0,16      // r2 = a_Multiplicand, sign-extended top half
+    SXTH R3,R0        // r3 = b_Multiplier, sign-extended bottom half
+    LSR R4,R0,31      // r4 = a_Sign, bit 31
+    UBFX R5,R0,15,1   // r5 = b_Sign, bit 15
+    EOR R6,R2,R2,ASR 31  // r6 = a_Abs: flip the bits if negative...
+    SUB R6,R6,R2,ASR 31  // ...and add 1 (subtracting -1)
+    EOR R7,R3,R3,ASR 31  // r7 = b_Abs, same trick
+    SUB R7,R7,R3,ASR 31
+    MUL R8,R6,R7      // r8 = init_Product = a_Abs * b_Abs
+    SMULTB R9,R0,R0   // r9 = final_Product = a * b
+    STM R1,{R2-R9}    // store all 8 fields of the struct
+    MOV R0,R9         // return final product
+    POP {r4-r9}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmMainCtx  ************/
+
+
+/* function: asmMainSat
+ *    inputs:   r0: contains packed value to be multiplied, same format
+ *                  as the asmMain input
+ *    outputs:  r0: saturated product: a and b are each clamped to
+ *                  ASM_SAT_OPERAND_BITS, and their product to ASM_SAT_BITS
+ *              memory:
+ *                  rng_Error:     1 if anything was clamped, else 0
+ *                  prod_Is_Neg:   1 if the returned product is < 0, else 0
+ *                  final_Product: same value as returned in r0
+ *    NOTE: single pass, no branches or conditional instructions.
+ *          Each range check is "does SSAT change the value?".
+ */  
+asmMainSat:   
+    /* int32 product = asmMainSat(uint packedValue) */
+    /*          R0                      R0         */
+    ASR R1,R0,16      // r1 = a, sign-extended top half
+    SXTH R2,R0        // r2 = b, sign-extended bottom half
+    SSAT R3,ASM_SAT_OPERAND_BITS,R1   // r3 = a clamped to operand range
+    EOR R1,R1,R3      // r1 != 0 if a was clamped
+    SSAT R12,ASM_SAT_OPERAND_BITS,R2  // r12 = b clamped to operand range
+    EOR R2,R2,R12     // r2 != 0 if b was clamped
+    ORR R1,R1,R2      // r1 != 0 if either operand was clamped
+    MUL R0,R3,R12     // r0 = product of the clamped operands
+    SSAT R2,ASM_SAT_BITS,R0  // r2 = product clamped to the Q-format range
+    EOR R0,R0,R2      // r0 != 0 if the product was clamped
+    ORR R1,R1,R0      // r1 != 0 on any range error
+    NEG R0,R1         // turn "r1 != 0" into 0 or 1 without a branch:
+    ORR R1,R1,R0      //   bit 31 of (x | -x) is set for any x != 0
+    LSR R1,R1,31      // r1 = rng_Error
+    LDR R3,=rng_Error
+    STR R1,[R3]
+    LSR R1,R2,31      // r1 = prod_Is_Neg, sign bit of the result
+    LDR R3,=prod_Is_Neg
+    STR R1,[R3]
+    LDR R3,=final_Product
+    STR R2,[R3]
+    MOV R0,R2         // return saturated product
+    BX LR             // return to caller
+/***************  END ---- asmMainSat  ************/
+
+
+/* function: asmMultN
+ *    inputs:   r0: address of the result, 2n words
+ *              r1: address of a, n words
+ *              r2: address of b, n words
+ *              r3: n, number of 32 bit words ("limbs") in a and b
+ *           where: a, b and the result are unsigned, least significant
+ *                  word first. The result must not overlap a or b.
+ *    outputs:  r0: No return value
+ *              memory: result = a * b
+ *    NOTE: schoolbook multiply, n*n UMAALs. UMAAL does
+ *          hi:lo = x*y + hi + lo, which is exactly one step of the
+ *          inner loop: r[i+j] + a[j]*b[i] + carry never overflows
+ *          64 bits. multN.c switches to Karatsuba for large n.
+ */  
+asmMultN:   
+    /* void asmMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) */
+    /*                        R0                R1                R2         R3   */
+    PUSH {r4-r10}     // save the callee-saved regs used by the loops
+    CBZ R3,4f         // nothing to do for n == 0
+    MOV R4,0          // clear the low n words of the result;
+    MOV R5,R3         // row 0 adds into them
+    MOV R6,R0
+1:  STR R4,[R6],4
+    SUBS R5,R5,1
+    BNE 1b
+    MOV R10,R3        // R10 = rows left (one per word of b)
+2:  LDR R7,[R2],4     // R7 = b[i]
+    MOV R5,R3         // R5 = words of a left in this row
+    MOV R6,R1         // R6 -> a[0]
+    MOV R12,R0        // R12 -> result[i]
+    MOV R8,0          // R8 = carry word
+3:  LDR R9,[R6],4     // R9 = a[j]
+    LDR R4,[R12]      // R4 = result[i+j]
+    UMAAL R4,R8,R9,R7 // R8:R4 = a[j]*b[i] + result[i+j] + carry
+    STR R4,[R12],4    // result[i+j] = low word, R8 = new carry
+    SUBS R5,R5,1
+    BNE 3b
+    STR R8,[R12]      // result[i+n] = last carry
+    ADD R0,R0,4       // next row starts one word higher
+    SUBS R10,R10,1
+    BNE 2b
+4:  POP {r4-r10}      // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmMultN  ************/
 .end   /* the assembler will ignore anything after this line. */
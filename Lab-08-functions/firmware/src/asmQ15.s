@@ -0,0 +1,180 @@
+/*** asmQ15.s   ***/
+/* Q15 fixed-point functions on the same packed format as asmMult.s:
+ * MSB 16bits and LSB 16bits of a word are two signed Q15 values
+ * (0x7FFF = 0.99997, 0x8000 = -1.0). asmCmul/asmCmulConj read the
+ * pair as one complex value instead. testFuncs.c has a C reference
+ * model for each of these.
+ */
+
+/* Tell the assembler to allow both 16b and 32b extended Thumb instructions */
+.syntax unified
+
+#include <xc.h>
+
+ /* Tell the assembler that what follows is in instruction memory    */
+.text
+.align
+
+.global asmQ15Mul, asmQ15Mac, asmQ15Add, asmQ15Sub, asmQ15Scale
+.type asmQ15Mul,%function
+.type asmQ15Mac,%function
+.type asmQ15Add,%function
+.type asmQ15Sub,%function
+.type asmQ15Scale,%function
+
+.global asmCmul, asmCmulConj
+.type asmCmul,%function
+.type asmCmulConj,%function
+
+/* function: asmQ15Mul
+ *    inputs:   r0: packed Q15 pair x
+ *              r1: packed Q15 pair y
+ *    outputs:  r0: packed Q15 pair: x.hi*y.hi and x.lo*y.lo, each
+ *                  rounded to nearest and saturated to Q15
+ *                  (-1.0 * -1.0 gives 0x7FFF)
+ */
+asmQ15Mul:
+    /* uint32 xy = asmQ15Mul(uint32 x, uint32 y) */
+    /*      R0                     R0        R1  */
+    SMULTT R2,R0,R1   // Q30 product of the top halves
+    SMULBB R3,R0,R1   // Q30 product of the bottom halves
+    ADD R2,R2,0x4000  // add 0.5 LSB for rounding
+    ADD R3,R3,0x4000
+    SSAT R2,16,R2,ASR 15  // back to Q15, saturated
+    SSAT R3,16,R3,ASR 15
+    PKHBT R0,R3,R2,LSL 16 // pack: top = R2, bottom = R3
+    BX LR             // return to caller
+/***************  END ---- asmQ15Mul  ************/
+
+
+/* function: asmQ15Mac
+ *    inputs:   r0: Q30 accumulator
+ *              r1: packed Q15 pair x
+ *              r2: packed Q15 pair y
+ *    outputs:  r0: acc + x.hi*y.hi + x.lo*y.lo, in Q30. Each add
+ *                  saturates (QADD), top halves first
+ */
+asmQ15Mac:
+    /* int32 acc = asmQ15Mac(int32 acc, uint32 x, uint32 y) */
+    /*      R0                     R0          R1        R2  */
+    SMULTT R3,R1,R2   // Q30 product of the top halves
+    SMULBB R12,R1,R2  // Q30 product of the bottom halves
+    QADD R0,R0,R3     // saturating acc += top product
+    QADD R0,R0,R12    // saturating acc += bottom product
+    BX LR             // return to caller
+/***************  END ---- asmQ15Mac  ************/
+
+
+/* function: asmQ15Add
+ *    inputs:   r0: packed Q15 pair x
+ *              r1: packed Q15 pair y
+ *    outputs:  r0: packed Q15 pair x + y, each half saturated
+ */
+asmQ15Add:
+    /* uint32 sum = asmQ15Add(uint32 x, uint32 y) */
+    /*       R0                      R0        R1  */
+    QADD16 R0,R0,R1   // both halves, saturating
+    BX LR             // return to caller
+/***************  END ---- asmQ15Add  ************/
+
+
+/* function: asmQ15Sub
+ *    inputs:   r0: packed Q15 pair x
+ *              r1: packed Q15 pair y
+ *    outputs:  r0: packed Q15 pair x - y, each half saturated
+ */
+asmQ15Sub:
+    /* uint32 diff = asmQ15Sub(uint32 x, uint32 y) */
+    /*       R0                       R0        R1  */
+    QSUB16 R0,R0,R1   // both halves, saturating
+    BX LR             // return to caller
+/***************  END ---- asmQ15Sub  ************/
+
+
+/* function: asmQ15Scale
+ *    inputs:   r0: packed Q15 pair x
+ *              r1: Q15 gain g, -32768..32767 in a 32 bit int
+ *    outputs:  r0: packed Q15 pair x.hi*g and x.lo*g, rounded down
+ *                  and saturated to Q15
+ *    NOTE: SMULWx computes (32 bit * 16 bit) >> 16. With 2*g as the
+ *          32 bit operand that is (g * x) >> 15, a Q15 result.
+ */
+asmQ15Scale:
+    /* uint32 gx = asmQ15Scale(uint32 x, int32 g) */
+    /*      R0                        R0       R1  */
+    LSL R1,R1,1       // 2*g so the >>16 gives a Q15 result
+    SMULWT R2,R1,R0   // top half * g
+    SMULWB R3,R1,R0   // bottom half * g
+    SSAT R2,16,R2     // -1.0 * -1.0 needs saturating
+    SSAT R3,16,R3
+    PKHBT R0,R3,R2,LSL 16 // pack: top = R2, bottom = R3
+    BX LR             // return to caller
+/***************  END ---- asmQ15Scale  ************/
+
+
+/* function: asmCmul
+ *    inputs:   r0: address of array x of complex Q15 values
+ *              r1: address of array y of complex Q15 values
+ *              r2: address of array for the results
+ *              r3: number of complex values (n)
+ *           where: each word is one complex value:
+ *                  MSB 16bits = imaginary part, LSB 16bits = real part
+ *    outputs:  r0: No return value
+ *              memory: out[i] = x[i] * y[i], complex Q15, rounded down
+ *                      and saturated
+ *    NOTE: real = xr*yr - xi*yi is one SMUSD, which can't overflow.
+ *          imag = xr*yi + xi*yr can: -1-1j * -1-1j gives +2.0, which
+ *          doesn't fit in a 32 bit Q30 sum (SMUADX would wrap it to
+ *          -2.0). So the two products are added with QADD, which
+ *          saturates, and SSAT then gives 0x7FFF.
+ */
+asmCmul:
+    /* void asmCmul(const uint32_t *x, const uint32_t *y, uint32_t *out, size_t n) */
+    /*                              R0                R1            R2         R3   */
+    PUSH {r4-r6}      // save the callee-saved regs used by the loop
+    CBZ R3,2f         // nothing to do for n == 0
+1:  LDR R4,[R0],4     // x[i]
+    LDR R5,[R1],4     // y[i]
+    SMUSD R12,R4,R5   // real = xr*yr - xi*yi (Q30)
+    SMULBT R6,R4,R5   // xr*yi (Q30)
+    SMULTB R4,R4,R5   // xi*yr (Q30)
+    QADD R4,R4,R6     // imag = xr*yi + xi*yr, saturated
+    SSAT R12,16,R12,ASR 15 // back to Q15, saturated
+    SSAT R4,16,R4,ASR 15
+    PKHBT R4,R12,R4,LSL 16 // pack: imag on top, real on bottom
+    STR R4,[R2],4     // out[i]
+    SUBS R3,R3,1
+    BNE 1b
+2:  POP {r4-r6}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmCmul  ************/
+
+
+/* function: asmCmulConj
+ *    same inputs as asmCmul
+ *    outputs:  memory: out[i] = x[i] * conj(y[i]), complex Q15
+ *    NOTE: imag = xi*yr - xr*yi is one SMUSDX with the operands
+ *          swapped, which can't overflow. real = xr*yr + xi*yi is the
+ *          sum that can, so it is two products and a QADD, as in asmCmul.
+ */
+asmCmulConj:
+    /* void asmCmulConj(const uint32_t *x, const uint32_t *y, uint32_t *out, size_t n) */
+    /*                                  R0                R1            R2         R3   */
+    PUSH {r4-r6}      // save the callee-saved regs used by the loop
+    CBZ R3,2f         // nothing to do for n == 0
+1:  LDR R4,[R0],4     // x[i]
+    LDR R5,[R1],4     // y[i]
+    SMULBB R12,R4,R5  // xr*yr (Q30)
+    SMULTT R6,R4,R5   // xi*yi (Q30)
+    QADD R12,R12,R6   // real = xr*yr + xi*yi, saturated
+    SMUSDX R4,R5,R4   // imag = yr*xi - yi*xr (Q30)
+    SSAT R12,16,R12,ASR 15 // back to Q15, saturated
+    SSAT R4,16,R4,ASR 15
+    PKHBT R4,R12,R4,LSL 16 // pack: imag on top, real on bottom
+    STR R4,[R2],4     // out[i]
+    SUBS R3,R3,1
+    BNE 1b
+2:  POP {r4-r6}       // restore caller registers
+    BX LR             // return to caller
+/***************  END ---- asmCmulConj  ************/
+.end   /* the assembler will ignore anything after this line. */
@@ -0,0 +1,65 @@
+/*** asmQsq.s   ***/
+/* Quarter-squares multiply: a third way to multiply next to the
+ * shift-add loop (asmMultShiftAdd) and the MUL instruction (asmMultHw).
+ *     a*b = f(a+b) - f(|a-b|),  f(x) = floor(x*x/4)
+ * The floors cancel because a+b and a-b are both even or both odd.
+ *
+ * The table of f is generated by the assembler at build time (.rept
+ * below), so there is no generator program to run and nothing to keep
+ * in sync. It goes in its own .qsq_table section, which
+ * ATSAME51J20A.ld places in flash on a cache-line boundary.
+ */
+
+/* Tell the assembler to allow both 16b and 32b extended Thumb instructions */
+.syntax unified
+
+#include <xc.h>
+
+/* largest operand is 2^QSQ_OPERAND_BITS - 1. The table has
+ * 2^(QSQ_OPERAND_BITS+1) - 1 words: 8191 words (32 KB) for 12 bits.
+ * testFuncs.h has the C copy of this, keep them in sync */
+.ifndef QSQ_OPERAND_BITS
+.equ QSQ_OPERAND_BITS, 12
+.endif
+.equ QSQ_TABLE_LEN, (1 << (QSQ_OPERAND_BITS + 1)) - 1
+
+.section .qsq_table,"a",%progbits
+.align 4
+.global qsqTable
+.type qsqTable,%object
+qsqTable:
+.set qsqX, 0
+.rept QSQ_TABLE_LEN
+    .word (qsqX * qsqX) / 4
+    .set qsqX, qsqX + 1
+.endr
+.size qsqTable, . - qsqTable
+
+ /* Tell the assembler that what follows is in instruction memory    */
+.text
+.align
+
+.global asmMultQsq
+.type asmMultQsq,%function
+
+/* function: asmMultQsq
+ *    inputs:   r0: unsigned multiplicand a, 0 .. 2^QSQ_OPERAND_BITS - 1
+ *              r1: unsigned multiplier b, same range
+ *    outputs:  r0: a * b
+ *    NOTE: no range check; a larger a or b reads past the table.
+ *          Two table loads from flash, so the speed depends on the
+ *          flash wait states and the CMCC cache (see benchAsmMultQsq).
+ */
+asmMultQsq:
+    /* int32 product = asmMultQsq(int32 a, int32 b) */
+    /*        R0                        R0       R1  */
+    ADD R2,R0,R1      // r2 = a + b
+    SUBS R3,R0,R1     // r3 = a - b
+    RSBMI R3,R3,0     // r3 = |a - b|
+    LDR R12,=qsqTable
+    LDR R2,[R12,R2,LSL 2]  // f(a + b)
+    LDR R3,[R12,R3,LSL 2]  // f(|a - b|)
+    SUB R0,R2,R3      // a * b
+    BX LR             // return to caller
+/***************  END ---- asmMultQsq  ************/
+.end   /* the assembler will ignore anything after this line. */
@@ -0,0 +1,677 @@
+/* ************************************************************************** */
+/** Benchmark functions for the asm kernels
+
+  @File Name
+    benchFuncs.c
+
+  @Summary
+    Cycle-count comparisons of the asmMult.s kernels.
+
+  @Description
+    Each benchmark runs with interrupts off so the RTC and DMA handlers
+    don't land inside a measurement, then turns them back on to print.
+ */
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Included Files                                                    */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stddef.h>                     // Defines NULL
+#include <stdbool.h>                    // Defines true
+#include <string.h>
+#include <inttypes.h>
+#include "definitions.h"                // SYS function prototypes
+#include "asmExterns.h"
+#include "benchFuncs.h"
+#include "multN.h"
+#include "firFilter.h"
+#include "printFuncs.h"  // lab print funcs
+#include "testFuncs.h"   // QSQ_OPERAND_BITS
+
+
+#define MAX_PRINT_LEN 1000
+
+static uint8_t txBuffer[MAX_PRINT_LEN] = {0};
+
+// number of packed values per batch benchmark run
+#define BATCH_LEN 256
+
+// calls per operand class in benchAsmMultClz
+#define CLASS_REPS 64
+
+// operand pairs per kernel, class and cache setting in benchAsmMultQsq
+#define QSQ_BENCH_LEN 256
+
+// samples and taps in benchFir
+#define FIR_BENCH_LEN 256
+#define FIR_BENCH_TAPS 32
+
+// operand pairs per kernel in benchDiv
+#define DIV_BENCH_LEN 256
+
+// largest operand, in words, and calls per size in benchMultN
+#define MULTN_BENCH_MAX_LIMBS 64
+#define MULTN_BENCH_REPS 8
+
+typedef int32_t (*multFunc)(int32_t a, int32_t b);
+
+extern int32_t asmMain(uint32_t packedValue);
+
+// from ATSAME51J20A.ld, around the asmQsq.s table
+extern uint32_t __qsq_table_start[];
+extern uint32_t __qsq_table_end[];
+
+// libgcc's AEABI divide helpers. gcc inlines SDIV/UDIV for C's / on
+// the M4, so call them by name to see what the library costs.
+extern int32_t __aeabi_idiv(int32_t n, int32_t d);
+extern uint32_t __aeabi_uidiv(uint32_t n, uint32_t d);
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static void statsReset(benchStats *s)
+{
+    s->calls = 0;
+    s->minCycles = UINT32_MAX;
+    s->maxCycles = 0;
+    s->totalCycles = 0;
+    s->mismatches = 0;
+}
+
+static void statsAdd(benchStats *s, uint32_t cycles)
+{
+    s->calls += 1;
+    s->totalCycles += cycles;
+    if (cycles < s->minCycles)
+    {
+        s->minCycles = cycles;
+    }
+    if (cycles > s->maxCycles)
+    {
+        s->maxCycles = cycles;
+    }
+}
+
+// CMCC setup a benchmark can change, so it can be put back after
+typedef struct _cmccState
+{
+    uint32_t cfg;   // CMCC_CFG: which of the I/D caches are disabled
+    bool on;        // CMCC_SR.CSTS: cache enabled
+} cmccState;
+
+static void cmccSave(cmccState *c)
+{
+    c->cfg = CMCC_REGS->CMCC_CFG;
+    c->on = ((CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk) != 0);
+}
+
+// CFG can only be written with the cache off. The contents are
+// invalidated, since nothing kept them coherent while it was off.
+static void cmccRestore(const cmccState *c)
+{
+    CMCC_Disable();
+    CMCC_REGS->CMCC_CFG = c->cfg;
+    if (c->on)
+    {
+        CMCC_InvalidateAll();
+        CMCC_REGS->CMCC_CTRL = CMCC_CTRL_CEN_Msk;
+    }
+}
+
+// time one call of a 2-operand multiply kernel, return its result in *prod
+static uint32_t timeMult(multFunc f, int32_t a, int32_t b, int32_t *prod)
+{
+    uint32_t start = DWT->CYCCNT;
+    *prod = f(a, b);
+    return DWT->CYCCNT - start;
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+void benchInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+void benchAsmMult(volatile bool *txComplete)
+{
+    static benchStats shiftAdd;
+    static benchStats hw;
+    statsReset(&shiftAdd);
+    statsReset(&hw);
+
+    benchInit();
+    __disable_irq();
+    for (int32_t a = 0; a <= 0x10000; ++a)
+    {
+        int32_t b = 0x10000 - a;
+        int32_t refProd = 0;
+        int32_t hwProd = 0;
+
+        statsAdd(&shiftAdd, timeMult(asmMultShiftAdd, a, b, &refProd));
+        statsAdd(&hw, timeMult(asmMultHw, a, b, &hwProd));
+        if (hwProd != refProd)
+        {
+            hw.mismatches += 1;
+        }
+    }
+    __enable_irq();
+
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= asmMult cycle comparison, a = 0..65536, b = 65536-a\r\n"
+            "kernel            calls    min    max    avg  mismatches\r\n"
+            "asmMultShiftAdd %7" PRIu32 " %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  (reference)\r\n"
+            "asmMultHw       %7" PRIu32 " %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  %" PRIu32 "\r\n"
+            "========= END -- asmMult cycle comparison\r\n"
+            "\r\n",
+            shiftAdd.calls, shiftAdd.minCycles, shiftAdd.maxCycles,
+            shiftAdd.totalCycles / shiftAdd.calls,
+            hw.calls, hw.minCycles, hw.maxCycles,
+            hw.totalCycles / hw.calls, hw.mismatches
+            );
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+
+void benchAsmMainBatch(volatile bool *txComplete)
+{
+    static uint32_t packed[BATCH_LEN];
+    static int32_t loopOut[BATCH_LEN];
+    static int32_t batchOut[BATCH_LEN];
+    uint32_t mismatches = 0;
+
+    // spread the inputs over all sign combinations and magnitudes
+    uint32_t seed = 0x12345678;
+    for (uint32_t i = 0; i < BATCH_LEN; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        packed[i] = seed;
+    }
+
+    benchInit();
+    __disable_irq();
+    uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < BATCH_LEN; ++i)
+    {
+        loopOut[i] = asmMain(packed[i]);
+    }
+    uint32_t loopCycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    asmMainBatch(packed, batchOut, BATCH_LEN);
+    uint32_t batchCycles = DWT->CYCCNT - start;
+    __enable_irq();
+
+    for (uint32_t i = 0; i < BATCH_LEN; ++i)
+    {
+        if (loopOut[i] != batchOut[i])
+        {
+            mismatches += 1;
+        }
+    }
+
+    // cycles/element printed with 2 decimals, without pulling in float printf
+    uint32_t loopCpe = (loopCycles * 100) / BATCH_LEN;
+    uint32_t batchCpe = (batchCycles * 100) / BATCH_LEN;
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= asmMainBatch throughput, %d packed values\r\n"
+            "asmMain loop:  %8" PRIu32 " cycles; %" PRIu32 ".%02" PRIu32 " cycles/element\r\n"
+            "asmMainBatch:  %8" PRIu32 " cycles; %" PRIu32 ".%02" PRIu32 " cycles/element\r\n"
+            "mismatches:    %8" PRIu32 "\r\n"
+            "========= END -- asmMainBatch throughput\r\n"
+            "\r\n",
+            BATCH_LEN,
+            loopCycles, loopCpe / 100, loopCpe % 100,
+            batchCycles, batchCpe / 100, batchCpe % 100,
+            mismatches
+            );
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+
+
+void benchAsmMultClz(volatile bool *txComplete)
+{
+    static const struct
+    {
+        char *name;
+        int32_t a;
+        int32_t b;
+    } classes[] = {
+        { "small x large", 0x0003, 0xFFFF },
+        { "large x small", 0xFFFF, 0x0003 },
+        { "both max     ", 0xFFFF, 0xFFFF },
+    };
+    static benchStats shiftAdd[sizeof(classes)/sizeof(classes[0])];
+    static benchStats clz[sizeof(classes)/sizeof(classes[0])];
+    uint32_t numClasses = sizeof(classes)/sizeof(classes[0]);
+
+    benchInit();
+    __disable_irq();
+    for (uint32_t c = 0; c < numClasses; ++c)
+    {
+        statsReset(&shiftAdd[c]);
+        statsReset(&clz[c]);
+        for (uint32_t rep = 0; rep < CLASS_REPS; ++rep)
+        {
+            int32_t refProd = 0;
+            int32_t clzProd = 0;
+
+            statsAdd(&shiftAdd[c],
+                    timeMult(asmMultShiftAdd, classes[c].a, classes[c].b, &refProd));
+            statsAdd(&clz[c],
+                    timeMult(asmMultClz, classes[c].a, classes[c].b, &clzProd));
+            if (clzProd != refProd)
+            {
+                clz[c].mismatches += 1;
+            }
+        }
+    }
+    __enable_irq();
+
+    for (uint32_t c = 0; c < numClasses; ++c)
+    {
+        // reduction in worst-case latency, in percent of the old one
+        uint32_t saved = 0;
+        if (clz[c].maxCycles < shiftAdd[c].maxCycles)
+        {
+            saved = 100 * (shiftAdd[c].maxCycles - clz[c].maxCycles)
+                    / shiftAdd[c].maxCycles;
+        }
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "asmMultClz %s (0x%04" PRIx32 " * 0x%04" PRIx32 "): "
+                "worst case %" PRIu32 " -> %" PRIu32 " cycles (-%" PRIu32 "%%); mismatches: %" PRIu32 "\r\n",
+                classes[c].name, classes[c].a, classes[c].b,
+                shiftAdd[c].maxCycles, clz[c].maxCycles, saved,
+                clz[c].mismatches
+                );
+        printAndWait((char *)txBuffer, txComplete);
+    }
+}
+
+
+void benchMultN(volatile bool *txComplete)
+{
+    static const uint32_t sizes[] = { 4, 8, 12, 16, 24, 32, 48, MULTN_BENCH_MAX_LIMBS };
+    static uint32_t a[MULTN_BENCH_MAX_LIMBS];
+    static uint32_t b[MULTN_BENCH_MAX_LIMBS];
+    static uint32_t schoolProd[2 * MULTN_BENCH_MAX_LIMBS];
+    static uint32_t karaProd[2 * MULTN_BENCH_MAX_LIMBS];
+    // one Karatsuba level: 4h + 2 limbs, h = n/2 rounded up
+    static uint32_t scratch[2 * MULTN_BENCH_MAX_LIMBS + 4];
+    uint32_t numSizes = sizeof(sizes)/sizeof(sizes[0]);
+    uint32_t crossover = 0;
+
+    uint32_t seed = 0x0BADF00D;
+    for (uint32_t i = 0; i < MULTN_BENCH_MAX_LIMBS; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        a[i] = seed;
+        seed = seed * 1664525 + 1013904223;
+        b[i] = seed;
+    }
+
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= asmMultN schoolbook vs one level of Karatsuba\r\n"
+            "words   schoolbook   karatsuba  mismatches\r\n");
+    printAndWait((char *)txBuffer, txComplete);
+
+    benchInit();
+    for (uint32_t s = 0; s < numSizes; ++s)
+    {
+        uint32_t n = sizes[s];
+        benchStats school;
+        benchStats kara;
+        statsReset(&school);
+        statsReset(&kara);
+
+        __disable_irq();
+        for (uint32_t rep = 0; rep < MULTN_BENCH_REPS; ++rep)
+        {
+            uint32_t start = DWT->CYCCNT;
+            asmMultN(schoolProd, a, b, n);
+            statsAdd(&school, DWT->CYCCNT - start);
+
+            // threshold == n: split once, halves go to asmMultN
+            start = DWT->CYCCNT;
+            multNKaratsuba(karaProd, a, b, n, scratch, n);
+            statsAdd(&kara, DWT->CYCCNT - start);
+        }
+        __enable_irq();
+
+        if (memcmp(schoolProd, karaProd, 2 * n * sizeof(uint32_t)) != 0)
+        {
+            kara.mismatches += 1;
+        }
+        // first size where splitting pays off
+        if ((crossover == 0) && (kara.minCycles < school.minCycles))
+        {
+            crossover = n;
+        }
+
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "%5" PRIu32 "  %11" PRIu32 "  %10" PRIu32 "  %" PRIu32 "\r\n",
+                n, school.minCycles, kara.minCycles, kara.mismatches);
+        printAndWait((char *)txBuffer, txComplete);
+    }
+
+    if (crossover != 0)
+    {
+        multNThreshold = crossover;
+    }
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "crossover: %" PRIu32 " words; multNThreshold set to %" PRIu32 "\r\n"
+            "========= END -- asmMultN schoolbook vs Karatsuba\r\n"
+            "\r\n",
+            crossover, (uint32_t)multNThreshold);
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+
+void benchDiv(volatile bool *txComplete)
+{
+    static uint32_t n[DIV_BENCH_LEN];
+    static uint32_t d[DIV_BENCH_LEN];
+    static uint32_t q[DIV_BENCH_LEN];
+    static benchStats libIdiv, asmIdiv, libUdiv, asmUdiv;
+    static benchStats libConst, asmConst, magicConst;
+    benchStats *all[] = { &libIdiv, &asmIdiv, &libUdiv, &asmUdiv,
+            &libConst, &asmConst, &magicConst };
+    divMagic by10;
+
+    // dividends over the whole range, divisors of every size so UDIV's
+    // early termination shows up in min/max
+    uint32_t seed = 0xD1D1D1D1;
+    for (uint32_t i = 0; i < DIV_BENCH_LEN; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        n[i] = seed;
+        seed = seed * 1664525 + 1013904223;
+        d[i] = (seed >> (i % 32)) | 1;
+    }
+    divMagicInit(&by10, 10);
+    for (uint32_t k = 0; k < sizeof(all)/sizeof(all[0]); ++k)
+    {
+        statsReset(all[k]);
+    }
+
+    benchInit();
+    __disable_irq();
+    for (uint32_t i = 0; i < DIV_BENCH_LEN; ++i)
+    {
+        int32_t sRef, sAsm;
+        uint32_t uRef, uAsm, uMagic;
+        uint32_t start;
+
+        start = DWT->CYCCNT;
+        sRef = __aeabi_idiv((int32_t)n[i], (int32_t)d[i]);
+        statsAdd(&libIdiv, DWT->CYCCNT - start);
+        start = DWT->CYCCNT;
+        sAsm = asmDiv((int32_t)n[i], (int32_t)d[i]);
+        statsAdd(&asmIdiv, DWT->CYCCNT - start);
+        if (sAsm != sRef)
+        {
+            asmIdiv.mismatches += 1;
+        }
+
+        start = DWT->CYCCNT;
+        uRef = __aeabi_uidiv(n[i], d[i]);
+        statsAdd(&libUdiv, DWT->CYCCNT - start);
+        start = DWT->CYCCNT;
+        uAsm = asmUDiv(n[i], d[i]);
+        statsAdd(&asmUdiv, DWT->CYCCNT - start);
+        if (uAsm != uRef)
+        {
+            asmUdiv.mismatches += 1;
+        }
+
+        // divide by the constant 10
+        start = DWT->CYCCNT;
+        uRef = __aeabi_uidiv(n[i], 10);
+        statsAdd(&libConst, DWT->CYCCNT - start);
+        start = DWT->CYCCNT;
+        uAsm = asmUDiv(n[i], 10);
+        statsAdd(&asmConst, DWT->CYCCNT - start);
+        start = DWT->CYCCNT;
+        uMagic = asmUDivConst(n[i], &by10);
+        statsAdd(&magicConst, DWT->CYCCNT - start);
+        if (uAsm != uRef)
+        {
+            asmConst.mismatches += 1;
+        }
+        if (uMagic != uRef)
+        {
+            magicConst.mismatches += 1;
+        }
+    }
+
+    uint32_t start = DWT->CYCCNT;
+    asmUDivConstN(n, q, DIV_BENCH_LEN, &by10);
+    uint32_t batchCycles = DWT->CYCCNT - start;
+    __enable_irq();
+
+    uint32_t batchMismatches = 0;
+    for (uint32_t i = 0; i < DIV_BENCH_LEN; ++i)
+    {
+        if (q[i] != n[i] / 10)
+        {
+            batchMismatches += 1;
+        }
+    }
+    uint32_t batchCpe = (batchCycles * 100) / DIV_BENCH_LEN;
+
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= divide cycle comparison, %d random (n, d) pairs\r\n"
+            "kernel              min    max    avg  mismatches\r\n"
+            "__aeabi_idiv     %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  (reference)\r\n"
+            "asmDiv           %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  %" PRIu32 "\r\n"
+            "__aeabi_uidiv    %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  (reference)\r\n"
+            "asmUDiv          %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  %" PRIu32 "\r\n"
+            "n / 10:\r\n"
+            "__aeabi_uidiv    %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  (reference)\r\n"
+            "asmUDiv          %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  %" PRIu32 "\r\n"
+            "asmUDivConst     %6" PRIu32 " %6" PRIu32 " %6" PRIu32 "  %" PRIu32 "\r\n"
+            "asmUDivConstN    %" PRIu32 ".%02" PRIu32 " cycles/element; mismatches: %" PRIu32 "\r\n"
+            "========= END -- divide cycle comparison\r\n"
+            "\r\n",
+            DIV_BENCH_LEN,
+            libIdiv.minCycles, libIdiv.maxCycles, libIdiv.totalCycles / libIdiv.calls,
+            asmIdiv.minCycles, asmIdiv.maxCycles, asmIdiv.totalCycles / asmIdiv.calls,
+            asmIdiv.mismatches,
+            libUdiv.minCycles, libUdiv.maxCycles, libUdiv.totalCycles / libUdiv.calls,
+            asmUdiv.minCycles, asmUdiv.maxCycles, asmUdiv.totalCycles / asmUdiv.calls,
+            asmUdiv.mismatches,
+            libConst.minCycles, libConst.maxCycles, libConst.totalCycles / libConst.calls,
+            asmConst.minCycles, asmConst.maxCycles, asmConst.totalCycles / asmConst.calls,
+            asmConst.mismatches,
+            magicConst.minCycles, magicConst.maxCycles,
+            magicConst.totalCycles / magicConst.calls, magicConst.mismatches,
+            batchCpe / 100, batchCpe % 100, batchMismatches
+            );
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+
+void benchAsmMultQsq(volatile bool *txComplete)
+{
+    static const struct
+    {
+        char *name;
+        multFunc f;
+    } kernels[] = {
+        { "asmMultShiftAdd", asmMultShiftAdd },
+        { "asmMultClz     ", asmMultClz },
+        { "asmMultHw      ", asmMultHw },
+        { "asmMultQsq     ", asmMultQsq },
+    };
+    static const uint32_t classBits[] = { 8, QSQ_OPERAND_BITS };
+    static int32_t a[QSQ_BENCH_LEN];
+    static int32_t b[QSQ_BENCH_LEN];
+    static benchStats stats[sizeof(kernels)/sizeof(kernels[0])];
+    uint32_t numKernels = sizeof(kernels)/sizeof(kernels[0]);
+    cmccState cmcc;
+
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= asmMultQsq vs ALU multiplies, %d random pairs per line\r\n"
+            "table: 0x%08" PRIx32 ", %" PRIu32 " bytes of flash\r\n",
+            QSQ_BENCH_LEN, (uint32_t)(uintptr_t)__qsq_table_start,
+            (uint32_t)((uintptr_t)__qsq_table_end - (uintptr_t)__qsq_table_start));
+    printAndWait((char *)txBuffer, txComplete);
+
+    benchInit();
+    cmccSave(&cmcc);
+    for (uint32_t cacheOn = 0; cacheOn < 2; ++cacheOn)
+    {
+        if (cacheOn)
+        {
+            CMCC_InvalidateAll();
+            CMCC_EnableICache();
+            CMCC_EnableDCache();
+        }
+        else
+        {
+            CMCC_Disable();
+        }
+
+        for (uint32_t c = 0; c < sizeof(classBits)/sizeof(classBits[0]); ++c)
+        {
+            uint32_t mask = (1 << classBits[c]) - 1;
+            uint32_t seed = 0x0A0B0C0D;
+            for (uint32_t i = 0; i < QSQ_BENCH_LEN; ++i)
+            {
+                seed = seed * 1664525 + 1013904223;
+                a[i] = (seed >> 8) & mask;
+                b[i] = (seed >> 20) & mask;
+            }
+
+            __disable_irq();
+            for (uint32_t k = 0; k < numKernels; ++k)
+            {
+                statsReset(&stats[k]);
+                for (uint32_t i = 0; i < QSQ_BENCH_LEN; ++i)
+                {
+                    int32_t prod = 0;
+                    statsAdd(&stats[k], timeMult(kernels[k].f, a[i], b[i], &prod));
+                    if (prod != a[i] * b[i])
+                    {
+                        stats[k].mismatches += 1;
+                    }
+                }
+            }
+            __enable_irq();
+
+            uint32_t best = 0;
+            for (uint32_t k = 1; k < numKernels; ++k)
+            {
+                if (stats[k].totalCycles < stats[best].totalCycles)
+                {
+                    best = k;
+                }
+            }
+            for (uint32_t k = 0; k < numKernels; ++k)
+            {
+                snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                        "%2" PRIu32 " bit, cache %s: %s avg %4" PRIu32 " max %4" PRIu32 " cycles; "
+                        "mismatches: %" PRIu32 "%s\r\n",
+                        classBits[c], cacheOn ? "on " : "off",
+                        kernels[k].name,
+                        stats[k].totalCycles / stats[k].calls, stats[k].maxCycles,
+                        stats[k].mismatches, (k == best) ? "  <- fastest" : "");
+                printAndWait((char *)txBuffer, txComplete);
+            }
+        }
+    }
+
+    // leave the cache the way we found it, so later benchmarks aren't
+    // timed with a different cache setup
+    cmccRestore(&cmcc);
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= END -- asmMultQsq vs ALU multiplies\r\n"
+            "\r\n");
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+
+void benchFir(volatile bool *txComplete)
+{
+    static int16_t h[FIR_BENCH_TAPS];
+    static int16_t in[FIR_BENCH_LEN];
+    static int16_t blockOut[FIR_BENCH_LEN];
+    static int16_t sampleOut[FIR_BENCH_LEN];
+    static uint32_t coefBuf[FIR_COEF_WORDS(FIR_BENCH_TAPS)];
+    static uint32_t stateBuf[FIR_STATE_WORDS(FIR_BENCH_TAPS)];
+    firFilter f;
+    uint32_t mismatches = 0;
+
+    uint32_t seed = 0x0F1F0F1F;
+    for (uint32_t k = 0; k < FIR_BENCH_TAPS; ++k)
+    {
+        seed = seed * 1664525 + 1013904223;
+        h[k] = (int16_t)(seed >> 16) / FIR_BENCH_TAPS;
+    }
+    for (uint32_t i = 0; i < FIR_BENCH_LEN; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        in[i] = (int16_t)(seed >> 16);
+    }
+    firInit(&f, h, FIR_BENCH_TAPS, coefBuf, stateBuf);
+
+    benchInit();
+    __disable_irq();
+    uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < FIR_BENCH_LEN; ++i)
+    {
+        firProcess(&f, &in[i], &sampleOut[i], 1);
+    }
+    uint32_t sampleCycles = DWT->CYCCNT - start;
+
+    firReset(&f);
+    start = DWT->CYCCNT;
+    firProcess(&f, in, blockOut, FIR_BENCH_LEN);
+    uint32_t blockCycles = DWT->CYCCNT - start;
+    __enable_irq();
+
+    for (uint32_t i = 0; i < FIR_BENCH_LEN; ++i)
+    {
+        if (sampleOut[i] != blockOut[i])
+        {
+            mismatches += 1;
+        }
+    }
+
+    uint32_t sampleCps = (sampleCycles * 100) / FIR_BENCH_LEN;
+    uint32_t blockCps = (blockCycles * 100) / FIR_BENCH_LEN;
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= firFilter throughput, %d taps, %d samples\r\n"
+            "one call per sample: %8" PRIu32 " cycles; %" PRIu32 ".%02" PRIu32 " cycles/sample\r\n"
+            "one call per block:  %8" PRIu32 " cycles; %" PRIu32 ".%02" PRIu32 " cycles/sample\r\n"
+            "mismatches:          %8" PRIu32 "\r\n"
+            "========= END -- firFilter throughput\r\n"
+            "\r\n",
+            FIR_BENCH_TAPS, FIR_BENCH_LEN,
+            sampleCycles, sampleCps / 100, sampleCps % 100,
+            blockCycles, blockCps / 100, blockCps % 100,
+            mismatches
+            );
+    printAndWait((char *)txBuffer, txComplete);
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/** Benchmark functions for the asm kernels
+
+  @File Name
+    benchFuncs.h
+
+  @Summary
+    Cycle-count comparisons of the asmMult.s kernels.
+
+  @Description
+    Uses the Cortex-M4 DWT cycle counter to time the different
+    implementations of the kernels in asmMult.s and prints a short
+    summary over the serial port.
+ */
+/* ************************************************************************** */
+
+#ifndef _BENCH_FUNCS_H    /* Guard against multiple inclusion */
+#define _BENCH_FUNCS_H
+
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Data Types
+    // *****************************************************************************
+    // *****************************************************************************
+
+// cycle statistics for one kernel; cycles include the call overhead
+typedef struct _benchStats
+{
+    uint32_t calls;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t totalCycles;
+    uint32_t mismatches;   // results that differ from the reference kernel
+} benchStats;
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Interface Functions
+    // *****************************************************************************
+    // *****************************************************************************
+
+// enable the DWT cycle counter. Safe to call more than once.
+void benchInit(void);
+
+// time asmMultShiftAdd and asmMultHw over every a in 0..2^16
+// (b = 2^16 - a) and print the comparison
+void benchAsmMult(volatile bool *txComplete);
+
+// cycles per element for asmMainBatch vs calling asmMain in a loop,
+// over the same array of packed values
+void benchAsmMainBatch(volatile bool *txComplete);
+
+// worst-case cycles of asmMultShiftAdd vs asmMultClz for each
+// operand class (small x large, large x small, both max)
+void benchAsmMultClz(volatile bool *txComplete);
+
+// min cycles of asmMultN vs one level of Karatsuba for 4..64 word
+// operands. Sets multNThreshold to the first size where Karatsuba wins
+// (leaves it alone if it never does)
+void benchMultN(volatile bool *txComplete);
+
+// cycles of asmDiv/asmUDiv vs libgcc's __aeabi_idiv/__aeabi_uidiv on
+// random operands, and of the three ways to divide by a constant
+void benchDiv(volatile bool *txComplete);
+
+// average and worst-case cycles of asmMultQsq vs asmMultShiftAdd,
+// asmMultClz and asmMultHw for 8 bit and QSQ_OPERAND_BITS operands,
+// with the CMCC cache off and then on. Puts the CMCC setup (enable
+// and the I/D cache disables) back the way it was.
+void benchAsmMultQsq(volatile bool *txComplete);
+
+// cycles per sample of a 32 tap firFilter, fed one sample per call
+// vs the whole block in one call
+void benchFir(volatile bool *txComplete);
+
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BENCH_FUNCS_H */
+
+/* *****************************************************************************
+ End of File
+ */
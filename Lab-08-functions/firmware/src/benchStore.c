@@ -0,0 +1,388 @@
+/* ************************************************************************** */
+/** Benchmark baseline store in SmartEEPROM
+
+  @File Name
+    benchStore.c
+
+  @Summary
+    See benchStore.h.
+
+  @Description
+    The baseline is a benchBaseline image at the start of the
+    SmartEEPROM, used in its default unbuffered mode: each 32 bit write
+    goes to flash by itself, and the next access waits for BUSY to
+    clear. A save clears the magic word first and writes it back last,
+    so a reset part way through leaves no baseline rather than half of
+    one; the CRC, over the rest of the header and the records, catches
+    anything else.
+ */
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Included Files                                                    */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stddef.h>                     // Defines NULL
+#include <stdbool.h>                    // Defines true
+#include <string.h>
+#include <inttypes.h>
+#include "definitions.h"                // SYS function prototypes
+#include "benchStore.h"
+#include "printFuncs.h"  // lab print funcs
+#ifdef NVMCTRL_HOST_SIM
+#include "nvmSim.h"      // the SmartEEPROM is the host model in nvmSim.c
+#define SEE_WORDS (nvmSimSee())
+#else
+#define SEE_WORDS ((volatile uint32_t *)SEEPROM_ADDR)
+#endif
+
+
+#define MAX_PRINT_LEN 1000
+
+// longest record, so the buffer is sent before it can overflow
+#define MAX_RECORD_LEN 100
+
+static uint8_t txBuffer[MAX_PRINT_LEN] = {0};
+
+// words before the records: magic, reserved/numRecords, saves, crc
+#define HEADER_WORDS 4
+
+// the CRC covers the header between magic and crc, then the records
+#define CRC_HEAD_OFFSET offsetof(benchBaseline, reserved)
+#define CRC_HEAD_BYTES (offsetof(benchBaseline, crc) - CRC_HEAD_OFFSET)
+
+_Static_assert(offsetof(benchBaseline, records) == HEADER_WORDS * 4,
+        "benchBaseline header is not HEADER_WORDS words");
+// SEESBLK = 1, SEEPSZ = 0 gives a 512 byte SmartEEPROM; a bigger one
+// (more blocks or a bigger page) only leaves room after the store
+_Static_assert(BENCH_STORE_BYTES <= 512,
+        "BENCH_STORE_BYTES is more than the smallest SmartEEPROM");
+_Static_assert(sizeof(benchBaseline) <= BENCH_STORE_BYTES,
+        "benchBaseline is bigger than BENCH_STORE_BYTES");
+
+static const char *kindNames[] = {
+    [BENCH_KIND_CYCLES] = "cycles",
+    [BENCH_KIND_PASSES] = "passes",
+};
+
+static const char *statusNames[] = {
+    [BENCH_STATUS_NEW]       = "new",
+    [BENCH_STATUS_OK]        = "ok",
+    [BENCH_STATUS_REGRESSED] = "regressed",
+    [BENCH_STATUS_IMPROVED]  = "improved",
+};
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// CRC-32 (IEEE, reflected), one bit at a time; the store is small.
+// Start with crc = 0xFFFFFFFF and invert the result after the last block.
+static uint32_t crc32Update(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    while (len-- != 0)
+    {
+        crc ^= *p++;
+        for (uint32_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+// CRC of reserved, numRecords and saves, then records[0..numRecords)
+static uint32_t baselineCrc(const benchBaseline *base)
+{
+    uint32_t crc = crc32Update(0xFFFFFFFF,
+            (const uint8_t *)base + CRC_HEAD_OFFSET, CRC_HEAD_BYTES);
+    crc = crc32Update(crc, base->records,
+            base->numRecords * sizeof(base->records[0]));
+    return ~crc;
+}
+
+static bool seeEnabled(void)
+{
+    return (NVMCTRL_SmartEEPROMStatusGet() & NVMCTRL_SEESTAT_SBLK_Msk) != 0U;
+}
+
+static void seeWait(void)
+{
+    while (NVMCTRL_SmartEEPROM_IsBusy());
+}
+
+// write one word of the store, unless it already holds v
+static void seeWrite(uint32_t word, uint32_t v)
+{
+    seeWait();
+    if (SEE_WORDS[word] != v)
+    {
+        seeWait();
+        SEE_WORDS[word] = v;
+    }
+}
+
+// index of the record in base with the same id and kind, or -1
+static int32_t findRecord(const benchBaseline *base, const benchRecord *r)
+{
+    for (uint32_t i = 0; i < base->numRecords; ++i)
+    {
+        if ((base->records[i].id == r->id) && (base->records[i].kind == r->kind))
+        {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+// add one BS record to txBuffer at *len, sending the buffer first if
+// it's nearly full
+static void appendLine(const char *line, int *len, volatile bool *txComplete)
+{
+    if (*len > MAX_PRINT_LEN - MAX_RECORD_LEN)
+    {
+        printAndWait((char *)txBuffer, txComplete);
+        *len = 0;
+    }
+    *len += snprintf((char*)txBuffer + *len, MAX_PRINT_LEN - *len, "%s", line);
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+void benchRunReset(benchRun *run)
+{
+    memset(run, 0, sizeof(*run));
+}
+
+
+bool benchRunAdd(benchRun *run, const char *name, benchKind kind, uint32_t value)
+{
+    if (run->numRecords >= BENCH_STORE_MAX_RECORDS)
+    {
+        return false;
+    }
+    uint32_t i = run->numRecords++;
+    run->records[i].id = benchRecordId(name, kind);
+    run->records[i].kind = (uint16_t)kind;
+    run->records[i].value = value;
+    run->names[i] = name;
+    run->status[i] = BENCH_STATUS_NEW;
+    return true;
+}
+
+
+// FNV-1a over the name and the kind, folded to 16 bits
+uint16_t benchRecordId(const char *name, benchKind kind)
+{
+    uint32_t h = 2166136261U;
+
+    while (*name != '\0')
+    {
+        h = (h ^ (uint8_t)*name++) * 16777619U;
+    }
+    h = (h ^ (uint8_t)kind) * 16777619U;
+    return (uint16_t)((h >> 16) ^ h);
+}
+
+
+benchStoreResult benchStoreLoad(benchBaseline *base)
+{
+    uint32_t *dst = (uint32_t *)base;
+
+    memset(base, 0, sizeof(*base));
+    if (!seeEnabled())
+    {
+        return BENCH_STORE_DISABLED;
+    }
+    seeWait();
+    volatile uint32_t *see = SEE_WORDS;
+    for (uint32_t i = 0; i < sizeof(*base) / 4; ++i)
+    {
+        dst[i] = see[i];
+    }
+    if ((base->magic != BENCH_STORE_MAGIC)
+            || (base->numRecords > BENCH_STORE_MAX_RECORDS)
+            || (base->crc != baselineCrc(base)))
+    {
+        memset(base, 0, sizeof(*base));
+        return BENCH_STORE_EMPTY;
+    }
+    return BENCH_STORE_OK;
+}
+
+
+benchStoreResult benchStoreSave(benchBaseline *base)
+{
+    const uint32_t *src = (const uint32_t *)base;
+
+    if (!seeEnabled())
+    {
+        return BENCH_STORE_DISABLED;
+    }
+    if ((NVMCTRL_SmartEEPROMStatusGet() & NVMCTRL_SEESTAT_LOCK_Msk) != 0U)
+    {
+        return BENCH_STORE_LOCKED;
+    }
+    base->magic = BENCH_STORE_MAGIC;
+    base->reserved = 0;
+    base->saves += 1;
+    base->crc = baselineCrc(base);
+
+    // magic off, records, rest of the header, magic on
+    seeWrite(0, 0);
+    uint32_t numWords = HEADER_WORDS
+            + base->numRecords * sizeof(base->records[0]) / 4;
+    for (uint32_t i = HEADER_WORDS; i < numWords; ++i)
+    {
+        seeWrite(i, src[i]);
+    }
+    for (uint32_t i = 1; i < HEADER_WORDS; ++i)
+    {
+        seeWrite(i, src[i]);
+    }
+    seeWrite(0, base->magic);
+    seeWait();
+    return BENCH_STORE_OK;
+}
+
+
+uint32_t benchStoreCompare(const benchBaseline *base, benchRun *run,
+        uint32_t thresholdPct)
+{
+    run->regressions = 0;
+    for (uint32_t i = 0; i < run->numRecords; ++i)
+    {
+        const benchRecord *r = &run->records[i];
+        int32_t b = findRecord(base, r);
+
+        run->baseValues[i] = 0;
+        run->status[i] = BENCH_STATUS_NEW;
+        if (b < 0)
+        {
+            continue;
+        }
+        uint32_t was = base->records[b].value;
+        run->baseValues[i] = was;
+        run->status[i] = BENCH_STATUS_OK;
+        if (r->kind == BENCH_KIND_PASSES)
+        {
+            if (r->value < was)
+            {
+                run->status[i] = BENCH_STATUS_REGRESSED;
+            }
+            else if (r->value > was)
+            {
+                run->status[i] = BENCH_STATUS_IMPROVED;
+            }
+        }
+        else
+        {
+            uint32_t slack = (uint32_t)(((uint64_t)was * thresholdPct) / 100);
+            if (slack < BENCH_STORE_MIN_SLACK)
+            {
+                slack = BENCH_STORE_MIN_SLACK;
+            }
+            if ((uint64_t)r->value > (uint64_t)was + slack)
+            {
+                run->status[i] = BENCH_STATUS_REGRESSED;
+            }
+            else if ((uint64_t)r->value + slack < was)
+            {
+                run->status[i] = BENCH_STATUS_IMPROVED;
+            }
+        }
+        if (run->status[i] == BENCH_STATUS_REGRESSED)
+        {
+            run->regressions += 1;
+        }
+    }
+    return run->regressions;
+}
+
+
+bool benchStoreMerge(benchBaseline *base, const benchRun *run, bool rebase)
+{
+    bool changed = false;
+
+    for (uint32_t i = 0; i < run->numRecords; ++i)
+    {
+        const benchRecord *r = &run->records[i];
+        int32_t b = findRecord(base, r);
+
+        if (b >= 0)
+        {
+            if (rebase && (base->records[b].value != r->value))
+            {
+                base->records[b].value = r->value;
+                changed = true;
+            }
+        }
+        else if (base->numRecords < BENCH_STORE_MAX_RECORDS)
+        {
+            base->records[base->numRecords++] = *r;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+
+uint32_t benchStoreBoot(benchRun *run, uint32_t thresholdPct, bool rebase,
+        volatile bool *txComplete)
+{
+    static benchBaseline base;
+    char line[MAX_RECORD_LEN];
+    int len = 0;
+
+    benchStoreResult loaded = benchStoreLoad(&base);
+    if (loaded == BENCH_STORE_DISABLED)
+    {
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "BS,disabled: SmartEEPROM is off (NVMCTRL_SEESBLK fuse is 0)\r\n"
+                "\r\n");
+        printAndWait((char *)txBuffer, txComplete);
+        return 0;
+    }
+
+    uint32_t regressions = benchStoreCompare(&base, run, thresholdPct);
+    appendLine("BS,name,kind,base,new,status\r\n", &len, txComplete);
+    for (uint32_t i = 0; i < run->numRecords; ++i)
+    {
+        snprintf(line, sizeof(line), "BS,%s,%s,%" PRIu32 ",%" PRIu32 ",%s\r\n",
+                run->names[i], kindNames[run->records[i].kind],
+                run->baseValues[i], run->records[i].value,
+                statusNames[run->status[i]]);
+        appendLine(line, &len, txComplete);
+    }
+
+    const char *baseline = "kept";
+    if (benchStoreMerge(&base, run, rebase))
+    {
+        benchStoreResult saved = benchStoreSave(&base);
+        baseline = (saved == BENCH_STORE_OK) ? "saved" : "LOCKED, not saved";
+    }
+    snprintf(line, sizeof(line),
+            "BS,end,regressions=%" PRIu32 ",threshold=%" PRIu32 "%%,baseline=%s,saves=%" PRIu32 "\r\n"
+            "\r\n",
+            regressions, thresholdPct, baseline, base.saves);
+    appendLine(line, &len, txComplete);
+    printAndWait((char *)txBuffer, txComplete);
+    return regressions;
+}
+
+/* *****************************************************************************
+ End of File
+ */
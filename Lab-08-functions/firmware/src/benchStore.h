@@ -0,0 +1,171 @@
+/* ************************************************************************** */
+/** Benchmark baseline store in SmartEEPROM
+
+  @File Name
+    benchStore.h
+
+  @Summary
+    Keeps a baseline of benchmark and test results in SmartEEPROM and
+    flags regressions against it on every boot.
+
+  @Description
+    A run is a list of named values: cycle counts (lower is better) and
+    test pass counts (higher is better). benchStoreBoot compares a run
+    with the stored baseline and prints one record per value:
+
+      BS,name,kind,base,new,status
+
+    status is ok, regressed, improved or new. A cycle count regresses
+    when it is more than thresholdPct percent (and BENCH_STORE_MIN_SLACK
+    cycles) over its baseline; a pass count regresses when it drops.
+
+    The baseline is written when there isn't a valid one, when asked to
+    rebase, and to add values it doesn't have yet; otherwise it is left
+    alone, so a slow drift still shows up against the original numbers.
+
+    The store takes the first BENCH_STORE_BYTES of the SmartEEPROM,
+    which is all of the smallest one (NVMCTRL_SEESBLK = 1,
+    NVMCTRL_SEEPSZ = 0 in initialization.c). With NVMCTRL_HOST_SIM
+    defined it runs against the model in nvmSim.c instead.
+ */
+/* ************************************************************************** */
+
+#ifndef _BENCH_STORE_H    /* Guard against multiple inclusion */
+#define _BENCH_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Constants
+    // *****************************************************************************
+    // *****************************************************************************
+
+// bytes of SmartEEPROM used: a 16 byte header and 8 byte records
+#define BENCH_STORE_BYTES 512
+#define BENCH_STORE_MAX_RECORDS ((BENCH_STORE_BYTES - 16) / 8)
+
+// "BSv2" in memory order; change the version if the layout changes.
+// v2: the CRC covers reserved, numRecords and saves too
+#define BENCH_STORE_MAGIC 0x32765342U
+
+// cycle counts this close to the baseline never count as regressions,
+// whatever the percentage says; a few cycles is noise on short kernels
+#define BENCH_STORE_MIN_SLACK 2
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Data Types
+    // *****************************************************************************
+    // *****************************************************************************
+
+typedef enum
+{
+    BENCH_KIND_CYCLES = 0,   // lower is better
+    BENCH_KIND_PASSES = 1,   // higher is better
+} benchKind;
+
+typedef enum
+{
+    BENCH_STATUS_NEW = 0,    // not in the baseline
+    BENCH_STATUS_OK,
+    BENCH_STATUS_REGRESSED,
+    BENCH_STATUS_IMPROVED,
+} benchStatus;
+
+typedef enum
+{
+    BENCH_STORE_OK = 0,
+    BENCH_STORE_EMPTY,       // no valid baseline (never written, or corrupt)
+    BENCH_STORE_DISABLED,    // NVMCTRL_SEESBLK fuse is 0: no SmartEEPROM
+    BENCH_STORE_LOCKED,      // SmartEEPROM is write-locked
+} benchStoreResult;
+
+// one stored value; id is a hash of the name and kind
+typedef struct _benchRecord
+{
+    uint16_t id;
+    uint16_t kind;
+    uint32_t value;
+} benchRecord;
+
+// the SmartEEPROM image
+typedef struct _benchBaseline
+{
+    uint32_t magic;
+    uint16_t reserved;       // 0
+    uint16_t numRecords;
+    uint32_t saves;          // times the baseline has been written
+    uint32_t crc;            // CRC-32 of reserved..saves, then records[0..numRecords)
+    benchRecord records[BENCH_STORE_MAX_RECORDS];
+} benchBaseline;
+
+// one boot's results, and how they compare with the baseline
+typedef struct _benchRun
+{
+    uint32_t numRecords;
+    benchRecord records[BENCH_STORE_MAX_RECORDS];
+    const char *names[BENCH_STORE_MAX_RECORDS];
+    uint32_t baseValues[BENCH_STORE_MAX_RECORDS];
+    benchStatus status[BENCH_STORE_MAX_RECORDS];
+    uint32_t regressions;
+} benchRun;
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Interface Functions
+    // *****************************************************************************
+    // *****************************************************************************
+
+// start an empty run
+void benchRunReset(benchRun *run);
+
+// add a value to the run. name must stay valid until the run is
+// printed. Returns false if the run is full.
+bool benchRunAdd(benchRun *run, const char *name, benchKind kind, uint32_t value);
+
+// the stored record id for name and kind
+uint16_t benchRecordId(const char *name, benchKind kind);
+
+// copy the stored baseline into *base. Returns BENCH_STORE_EMPTY (and
+// an empty *base) if there isn't a valid one.
+benchStoreResult benchStoreLoad(benchBaseline *base);
+
+// write base to the store; only words that changed are written
+benchStoreResult benchStoreSave(benchBaseline *base);
+
+// set run's status, baseValues and regressions from base. Returns the
+// number of regressions.
+uint32_t benchStoreCompare(const benchBaseline *base, benchRun *run,
+        uint32_t thresholdPct);
+
+// add run's values to base: all of them if rebase is true, otherwise
+// only the ones base doesn't have. Returns true if base changed.
+bool benchStoreMerge(benchBaseline *base, const benchRun *run, bool rebase);
+
+// load, compare, print the records and a summary line, and save the
+// baseline if it changed. Returns the number of regressions.
+uint32_t benchStoreBoot(benchRun *run, uint32_t thresholdPct, bool rebase,
+        volatile bool *txComplete);
+
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BENCH_STORE_H */
+
+/* *****************************************************************************
+ End of File
+ */
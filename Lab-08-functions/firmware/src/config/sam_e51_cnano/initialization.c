@@ -58,7 +58,7 @@
 #pragma config BOD33_ACTION = RESET
 #pragma config BOD33_HYST = 0x2
 #pragma config NVMCTRL_BOOTPROT = 0
-#pragma config NVMCTRL_SEESBLK = 0x0
+#pragma config NVMCTRL_SEESBLK = 0x1
 #pragma config NVMCTRL_SEEPSZ = 0x0
 #pragma config RAMECC_ECCDIS = SET
 #pragma config WDT_ENABLE = CLEAR
@@ -141,6 +141,8 @@ void SYS_Initialize ( void* data )
 
     RTC_Initialize();
 
+    TRNG_Initialize();
+
 
 
 
@@ -197,7 +197,6 @@ extern void DAC_RESRDY_1_Handler       ( void ) __attribute__((weak, alias("Dumm
 extern void I2S_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler")));
 extern void PCC_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler")));
 extern void AES_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler")));
-extern void TRNG_Handler               ( void ) __attribute__((weak, alias("Dummy_Handler")));
 extern void ICM_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler")));
 extern void PUKCC_Handler              ( void ) __attribute__((weak, alias("Dummy_Handler")));
 extern void QSPI_Handler               ( void ) __attribute__((weak, alias("Dummy_Handler")));
@@ -342,7 +341,7 @@ const H3DeviceVectors exception_table=
     .pfnI2S_Handler                = I2S_Handler,
     .pfnPCC_Handler                = PCC_Handler,
     .pfnAES_Handler                = AES_Handler,
-    .pfnTRNG_Handler               = TRNG_Handler,
+    .pfnTRNG_Handler               = TRNG_InterruptHandler,
     .pfnICM_Handler                = ICM_Handler,
     .pfnPUKCC_Handler              = PUKCC_Handler,
     .pfnQSPI_Handler               = QSPI_Handler,
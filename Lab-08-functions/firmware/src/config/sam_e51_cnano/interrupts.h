@@ -63,6 +63,7 @@ void HardFault_Handler (void);
 void RTC_InterruptHandler (void);
 void EIC_EXTINT_15_InterruptHandler (void);
 void DMAC_0_InterruptHandler (void);
+void TRNG_InterruptHandler (void);
 
 
 
@@ -65,6 +65,8 @@ void NVIC_Initialize( void )
     NVIC_EnableIRQ(EIC_EXTINT_15_IRQn);
     NVIC_SetPriority(DMAC_0_IRQn, 7);
     NVIC_EnableIRQ(DMAC_0_IRQn);
+    NVIC_SetPriority(TRNG_IRQn, 7);
+    NVIC_EnableIRQ(TRNG_IRQn);
 
 
 
@@ -49,7 +49,11 @@
 
 #include <string.h>
 #include "plib_nvmctrl.h"
+#ifdef NVMCTRL_HOST_SIM
+#include "nvmSim.h"    // NVMCTRL_REGS is the host model in nvmSim.c
+#else
 #include "interrupts.h"
+#endif
 
 static volatile uint16_t nvm_error;
 static uint16_t nvm_status;
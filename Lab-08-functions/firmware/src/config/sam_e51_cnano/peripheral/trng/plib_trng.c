@@ -0,0 +1,106 @@
+/*******************************************************************************
+  TRNG Peripheral Library
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_trng.c
+
+  Summary:
+    TRNG Source File
+
+  Description:
+    TRNG_ReadData polls for one random number. TRNG_RandomNumberGenerate
+    starts a conversion and returns; TRNG_InterruptHandler passes the
+    number to the registered callback. The TRNG is only enabled while a
+    number is being generated.
+
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#include "device.h"
+#include "peripheral/trng/plib_trng.h"
+#ifdef TRNG_HOST_SIM
+#include "trngSim.h"    // TRNG_REGS is the host model in trngSim.c
+#else
+#include "interrupts.h"
+#endif
+
+static TRNG_CALLBACK_OBJ trngObj;
+
+void TRNG_Initialize( void )
+{
+    TRNG_REGS->TRNG_CTRLA = (uint8_t)TRNG_CTRLA_RESETVALUE;
+    TRNG_REGS->TRNG_EVCTRL = (uint8_t)TRNG_EVCTRL_RESETVALUE;
+    TRNG_REGS->TRNG_INTENCLR = (uint8_t)TRNG_INTENCLR_DATARDY_Msk;
+    TRNG_REGS->TRNG_INTFLAG = (uint8_t)TRNG_INTFLAG_DATARDY_Msk;
+
+    trngObj.callback = NULL;
+    trngObj.context = 0U;
+}
+
+uint32_t TRNG_ReadData( void )
+{
+    TRNG_REGS->TRNG_CTRLA |= (uint8_t)TRNG_CTRLA_ENABLE_Msk;
+
+    while((TRNG_REGS->TRNG_INTFLAG & TRNG_INTFLAG_DATARDY_Msk) != TRNG_INTFLAG_DATARDY_Msk)
+    {
+        /* Wait for the random number */
+    }
+
+    TRNG_REGS->TRNG_CTRLA &= (uint8_t)(~TRNG_CTRLA_ENABLE_Msk);
+
+    return (TRNG_REGS->TRNG_DATA);
+}
+
+void TRNG_RandomNumberGenerate( void )
+{
+    if((TRNG_REGS->TRNG_CTRLA & TRNG_CTRLA_ENABLE_Msk) == 0U)
+    {
+        TRNG_REGS->TRNG_CTRLA |= (uint8_t)TRNG_CTRLA_ENABLE_Msk;
+    }
+    TRNG_REGS->TRNG_INTENSET = (uint8_t)TRNG_INTENSET_DATARDY_Msk;
+}
+
+void TRNG_CallbackRegister( TRNG_CALLBACK callback, uintptr_t context )
+{
+    trngObj.callback = callback;
+    trngObj.context = context;
+}
+
+void TRNG_InterruptHandler( void )
+{
+    TRNG_REGS->TRNG_INTENCLR = (uint8_t)TRNG_INTENCLR_DATARDY_Msk;
+    TRNG_REGS->TRNG_CTRLA &= (uint8_t)(~TRNG_CTRLA_ENABLE_Msk);
+
+    /* Reading the data clears the DATARDY flag */
+    uint32_t data = TRNG_REGS->TRNG_DATA;
+
+    if(trngObj.callback != NULL)
+    {
+        trngObj.callback(data, trngObj.context);
+    }
+}
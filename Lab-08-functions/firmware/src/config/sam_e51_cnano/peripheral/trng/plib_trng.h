@@ -0,0 +1,89 @@
+/*******************************************************************************
+  Interface definition of TRNG PLIB.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_trng.h
+
+  Summary:
+    Interface definition of the True Random Number Generator (TRNG) Plib
+
+  Description:
+    This file defines the interface for the TRNG Plib. It allows user to
+    read a random number either by polling or with an interrupt.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#ifndef PLIB_TRNG_H    // Guards against multiple inclusion
+#define PLIB_TRNG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus // Provide C++ Compatibility
+	extern "C" {
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+typedef void (*TRNG_CALLBACK)(uint32_t random, uintptr_t context);
+
+typedef struct
+{
+    TRNG_CALLBACK callback;
+    uintptr_t context;
+} TRNG_CALLBACK_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface
+// *****************************************************************************
+// *****************************************************************************
+
+/***************************** TRNG API *******************************/
+void TRNG_Initialize( void );
+
+uint32_t TRNG_ReadData( void );
+
+void TRNG_RandomNumberGenerate( void );
+
+void TRNG_CallbackRegister( TRNG_CALLBACK callback, uintptr_t context );
+
+void TRNG_InterruptHandler( void );
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+    }
+#endif
+
+#endif
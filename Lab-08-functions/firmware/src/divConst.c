@@ -0,0 +1,47 @@
+/* ************************************************************************** */
+/** Divide by a constant
+
+  @File Name
+    divConst.c
+
+  @Summary
+    Computes the magic numbers for asmUDivConst.
+
+  @Description
+    Granlund & Montgomery, "Division by Invariant Integers using
+    Multiplication", fig. 4.1: with l = ceil(log2(d)) and
+      magic = floor(2^32 * (2^l - d) / d) + 1
+    every 32 bit n gives
+      t = (n * magic) >> 32
+      n / d = (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0)
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "divConst.h"
+
+bool divMagicInit(divMagic *m, uint32_t d)
+{
+    if (d == 0)
+    {
+        return false;
+    }
+
+    // l = ceil(log2(d)), 0..32
+    uint32_t l = 0;
+    while ((l < 32) && (((uint64_t)1 << l) < d))
+    {
+        ++l;
+    }
+
+    m->magic = (uint32_t)((((uint64_t)1 << 32) * (((uint64_t)1 << l) - d)) / d + 1);
+    m->shift1 = (l < 1) ? l : 1;
+    m->shift2 = (l > 1) ? l - 1 : 0;
+    m->divisor = d;
+    return true;
+}
+
+/* *****************************************************************************
+ End of File
+ */
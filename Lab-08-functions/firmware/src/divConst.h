@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/** Divide by a constant
+
+  @File Name
+    divConst.h
+
+  @Summary
+    Magic numbers for asmUDivConst/asmUDivConstN (asmDiv.s, prototypes
+    in asmExterns.h).
+
+  @Description
+    When the divisor is known ahead of time, n / d is one UMULL, a
+    subtract, an add and two shifts. divMagicInit does the expensive
+    part (one 64 bit divide) once per divisor.
+ */
+/* ************************************************************************** */
+
+#ifndef _DIV_CONST_H    /* Guard against multiple inclusion */
+#define _DIV_CONST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// asmUDivConst loads magic, shift1 and shift2 with one LDM, so don't
+// reorder the fields without changing asmDiv.s too
+typedef struct _divMagic
+{
+    uint32_t magic;    // 2^32 * (2^l - d) / d + 1, l = ceil(log2(d))
+    uint32_t shift1;   // min(l, 1)
+    uint32_t shift2;   // max(l - 1, 0)
+    uint32_t divisor;  // d, not used by the asm
+} divMagic;
+
+// fill in *m for dividing by d. Returns false (and leaves *m alone)
+// for d == 0.
+bool divMagicInit(divMagic *m, uint32_t d);
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DIV_CONST_H */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/** Block FIR filter
+
+  @File Name
+    firFilter.c
+
+  @Summary
+    Setup and state handling for the asmFirBlock kernel.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "firFilter.h"
+
+// block kernel in asmFir.s. The host build has no asm, so it runs
+// the C version, which keeps the same state.
+#ifdef FIR_HOST_SIM
+#define FIR_BLOCK firBlockC
+#else
+extern void asmFirBlock(const int16_t *in, int16_t *out, size_t n, firFilter *f);
+#define FIR_BLOCK asmFirBlock
+#endif
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+bool firInit(firFilter *f, const int16_t *h, uint32_t numTaps,
+        uint32_t *coefBuf, uint32_t *stateBuf)
+{
+    if (numTaps == 0)
+    {
+        return false;
+    }
+
+    f->numTaps = 2 * FIR_COEF_WORDS(numTaps);
+    f->coefs = (int16_t *)coefBuf;
+    f->state = (int16_t *)stateBuf;
+
+    // reversed, so coefs[j] multiplies the j-th oldest sample.
+    // With an odd numTaps the padding tap is coefs[0], the oldest.
+    for (uint32_t j = 0; j < f->numTaps; ++j)
+    {
+        uint32_t k = f->numTaps - 1 - j;
+        f->coefs[j] = (k < numTaps) ? h[k] : 0;
+    }
+    firReset(f);
+    return true;
+}
+
+
+void firProcess(firFilter *f, const int16_t *in, int16_t *out, size_t n)
+{
+    FIR_BLOCK(in, out, n, f);
+}
+
+
+void firReset(firFilter *f)
+{
+    memset(f->state, 0, 2 * f->numTaps * sizeof(f->state[0]));
+    f->pos = 0;
+}
+
+
+void firBlockC(const int16_t *in, int16_t *out, size_t n, firFilter *f)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        int16_t x = in[i];
+        f->state[f->pos] = x;
+        f->state[f->pos + f->numTaps] = x;
+        f->pos = (f->pos + 1 == f->numTaps) ? 0 : f->pos + 1;
+
+        // wraps like SMLAD instead of saturating
+        uint32_t acc = 0;
+        const int16_t *window = &f->state[f->pos];
+        for (uint32_t j = 0; j < f->numTaps; ++j)
+        {
+            acc += (uint32_t)((int32_t)window[j] * f->coefs[j]);
+        }
+        int32_t y = (int32_t)acc >> 15;
+        out[i] = (y > INT16_MAX) ? INT16_MAX : (y < INT16_MIN) ? INT16_MIN : (int16_t)y;
+    }
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,78 @@
+/* ************************************************************************** */
+/** Block FIR filter
+
+  @File Name
+    firFilter.h
+
+  @Summary
+    int16 (Q15) FIR filter that processes a block of samples per call.
+
+  @Description
+    y[i] = sum over k of h[k] * x[i-k], k = 0 .. numTaps-1, accumulated
+    in 32 bits and returned as Q15 (>> 15, rounded down, saturated).
+    The 32 bit sum can't overflow as long as the sum of |h[k]| is less
+    than 2.0.
+
+    The caller owns all memory: the struct and two word buffers sized
+    with FIR_COEF_WORDS/FIR_STATE_WORDS. History carries over from one
+    firProcess call to the next, so a stream can be fed in blocks of
+    any size.
+
+    firProcess runs asmFirBlock (asmFir.s). With FIR_HOST_SIM defined,
+    as in the host build, it runs firBlockC instead.
+ */
+/* ************************************************************************** */
+
+#ifndef _FIR_FILTER_H    /* Guard against multiple inclusion */
+#define _FIR_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// buffer sizes, in 32 bit words, for a filter with n taps.
+// An odd n is padded with one zero tap.
+#define FIR_COEF_WORDS(n)  (((n) + 1) / 2)
+#define FIR_STATE_WORDS(n) (2 * FIR_COEF_WORDS(n))
+
+// asmFirBlock (asmFir.s) loads the first four fields with one LDM,
+// so don't reorder them without changing asmFir.s too
+typedef struct _firFilter
+{
+    int16_t *state;        // 2 * numTaps samples: circular buffer, stored twice
+    int16_t *coefs;        // numTaps taps, reversed: coefs[j] = h[numTaps-1-j]
+    uint32_t numTaps;      // after padding to an even number
+    uint32_t pos;          // index of the oldest sample in state
+} firFilter;
+
+// set up f for the numTaps Q15 taps in h, with all-zero history.
+// coefBuf and stateBuf must hold FIR_COEF_WORDS(numTaps) and
+// FIR_STATE_WORDS(numTaps) words. Returns false for numTaps == 0.
+bool firInit(firFilter *f, const int16_t *h, uint32_t numTaps,
+        uint32_t *coefBuf, uint32_t *stateBuf);
+
+// filter n samples from in to out. in and out may be the same array.
+void firProcess(firFilter *f, const int16_t *in, int16_t *out, size_t n);
+
+// clear the history, keep the taps
+void firReset(firFilter *f);
+
+// C version of asmFirBlock with the same state handling and results,
+// for builds without the asm kernel
+void firBlockC(const int16_t *in, int16_t *out, size_t n, firFilter *f);
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FIR_FILTER_H */
+
+/* *****************************************************************************
+ End of File
+ */
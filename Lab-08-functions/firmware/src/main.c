@@ -43,6 +43,14 @@
 #include "asmExterns.h"
 #include "testFuncs.h" // lab test structs
 #include "printFuncs.h"  // lab print funcs
+#include "benchFuncs.h"  // kernel cycle-count comparisons
+#include "microBench.h"  // per-kernel DWT cycle/stall records
+#include "benchStore.h"  // SmartEEPROM baseline, regression check
+#include "multN.h"  // multi-precision multiply (Karatsuba driver)
+#include "pukccMult.h"  // wide multiply on the PUKCC coprocessor
+#include "testVectors.h"  // tc[], the packed test cases
+#include "firFilter.h"  // block FIR filter
+#include "testRunner.h"  // table-driven kernel tests
 
 // Define the global that gives access to the student's name
 extern uint32_t nameStrPtr;
@@ -50,11 +58,45 @@ extern uint32_t nameStrPtr;
 // set to false to skip tests when debugging
 bool doUnpackTest  = true;
 bool doAbsTest     = true;
+bool doAbsPackedTest = true;
 bool doMultTest    = true;
 bool doFixSignTest = true;
 bool doAsmMainTest = true;
+bool doMainBatchTest = true;
+bool doDot16Test   = true;
+bool doQ15Test     = true;
+bool doCmulTest    = true;
+bool doAsmMainCtxTest = true;
+bool doAsmMainSatTest = true;
+bool doMultClzTest = true;
+bool doMultQsqTest = true;
+bool doMultNTest   = true;
+bool doPukccTest   = true;
+bool doDivTest     = true;
+bool doFirTest     = true;
+bool doRandomTest  = true;  // asmMainBatch on RANDOM_TEST_BATCHES random batches
+bool doSweepTest   = false; // asmMainBatch on every SWEEP_STRIDE-th packed
+                            // value; takes minutes at stride 1
+
+bool doMultBench   = true;  // compare asmMultShiftAdd vs asmMultHw cycles
+bool doBatchBench  = true;  // cycles/element, asmMainBatch vs asmMain loop
+bool doClzBench    = true;  // worst-case cycles, asmMultClz vs asmMultShiftAdd
+bool doMultNBench  = true;  // schoolbook vs Karatsuba crossover; sets multNThreshold
+bool doDivBench    = true;  // asmDiv.s vs the libgcc divide helpers
+bool doQsqBench    = true;  // quarter-squares table vs ALU multiplies, cache on/off
+bool doFirBench    = true;  // FIR cycles/sample, one call per block vs per sample
 
 bool onlyPrintFails = true; // set this to false to see passing test cases, too
+bool turboTests = false;    // true: no 10 ms wait between test cases, one
+                            // timed summary at the end instead of one per
+                            // case. The times include the checkers.
+bool microBenchMode = false; // true: skip the tests, just send the
+                            // microBenchAll records. Holding SW0 during
+                            // reset does the same.
+bool doBenchStore  = true;  // compare this boot's cycles and pass counts
+                            // with the baseline in SmartEEPROM
+bool benchStoreRebase = false; // true: make this boot's numbers the
+                            // new baseline
 
 /* RTC Time period match values for input clock of 1 KHz */
 #define PERIOD_10MS                             10
@@ -66,6 +108,17 @@ bool onlyPrintFails = true; // set this to false to see passing test cases, too
 
 #define MAX_PRINT_LEN 1000
 
+// step between packed values in the sweep test. 1 checks all 2^32.
+#define SWEEP_STRIDE 1
+
+// cycle counts more than this much over the baseline are regressions
+#define BENCH_STORE_THRESHOLD_PCT 5
+
+// random tests: 0 seeds the run from the TRNG; put the seed printed by a
+// failing run here to replay it. Batches are 256 values each.
+#define RANDOM_TEST_SEED 0
+#define RANDOM_TEST_BATCHES 4096
+
 static volatile bool isRTCExpired = false;
 static volatile bool changeTempSamplingRate = false;
 static volatile bool isUSARTTxComplete = true;
@@ -73,22 +126,6 @@ static uint8_t uartTxBuffer[MAX_PRINT_LEN] = {0};
 
 
 
-// the following array defines pairs of {balance, transaction} values
-// tc stands for test case
-static int32_t tc[] = {
-    0x00020003,
-    0xFFFC0003,  // -,+
-    0x00000000,  // 0,0
-    0x00000005,  // 0,+
-    0x0000FFFC,  // 0,-
-    0xFFFD0000,  // -,0
-    0x00020000,  // +,0
-    0x80008000,  // -,-
-    0xFFF3FFE0,  // -,-
-    0x7FF38001,  // +,-
-    0x7FF17FF2   // +,+
-};
-
 // static char * pass = "PASS";
 // static char * fail = "FAIL";
 
@@ -129,6 +166,70 @@ extern int32_t init_Product;
 extern int32_t final_Product;
 #endif
 
+// the asmQ15.s functions for one row of the table
+static void q15Group(uint32_t x, uint32_t y, int32_t acc, int32_t gain, q15Results *r)
+{
+    r->mul = asmQ15Mul(x, y);
+    r->mac = asmQ15Mac(acc, x, y);
+    r->add = asmQ15Add(x, y);
+    r->sub = asmQ15Sub(x, y);
+    r->scale = asmQ15Scale(x, gain);
+}
+
+// the asmDiv.s functions for one row of the table
+static void divGroup(int32_t n, int32_t d, divResults *r)
+{
+    r->quot = asmDiv(n, d);
+    r->rem = asmMod(n, d);
+    r->dmQuot = asmDivMod(n, d, &r->dmRem);
+    r->uQuot = asmUDiv(n, d);
+    r->uRem = asmUMod(n, d);
+    r->udmQuot = asmUDivMod(n, d, &r->udmRem);
+}
+
+// every kernel test, in the order they are run. The first
+// NUM_LAB_KERNELS rows are the asmMult.s functions the lab is scored
+// on. A row with numCases 0 runs once per tc[] case; the others make
+// their own inputs (see testRunner.h). A kernel with the same arguments
+// as one of these is one more row with the same checkXxxCase adapter.
+enum {
+    KT_UNPACK, KT_ABS, KT_MULT, KT_FIX_SIGN, KT_MAIN,
+    KT_ABS_PACKED, KT_MAIN_BATCH, KT_MULT_CLZ, KT_MULT_CLZ_BA, KT_MULT_QSQ,
+    KT_MAIN_CTX, KT_MAIN_SAT, KT_DOT16, KT_MAC16, KT_Q15, KT_CMUL,
+    KT_CMUL_CONJ, KT_MULT_N, KT_KARATSUBA, KT_PUKCC_MULT, KT_PUKCC_MOD_MULT,
+    KT_DIV, KT_UDIV_CONST, KT_UDIV_CONST_N, KT_FIR,
+    NUM_KERNEL_TESTS
+};
+#define NUM_LAB_KERNELS (KT_MAIN + 1)
+static const kernelTest kernelTests[NUM_KERNEL_TESTS] = {
+    [KT_UNPACK]     = { "asmUnpack",  (kernelFunc)asmUnpack,  checkUnpackCase,  &doUnpackTest },
+    [KT_ABS]        = { "asmAbs",     (kernelFunc)asmAbs,     checkAbsCase,     &doAbsTest },
+    [KT_MULT]       = { "asmMult",    (kernelFunc)asmMult,    checkMultCase,    &doMultTest },
+    [KT_FIX_SIGN]   = { "asmFixSign", (kernelFunc)asmFixSign, checkFixSignCase, &doFixSignTest },
+    [KT_MAIN]       = { "asmMain",    (kernelFunc)asmMain,    checkMainCase,    &doAsmMainTest },
+    [KT_ABS_PACKED] = { "asmAbsPacked", (kernelFunc)asmAbsPacked, checkAbsPackedCase, &doAbsPackedTest },
+    [KT_MAIN_BATCH] = { "asmMainBatch", (kernelFunc)asmMainBatch, checkMainBatchCase, &doMainBatchTest },
+    [KT_MULT_CLZ]   = { "asmMultClz", (kernelFunc)asmMultClz, checkMultCase,    &doMultClzTest },
+    [KT_MULT_CLZ_BA] = { "asmMultClz(b,a)", (kernelFunc)asmMultClz, checkMultSwappedCase, &doMultClzTest },
+    [KT_MULT_QSQ]   = { "asmMultQsq", (kernelFunc)asmMultQsq, checkMultQsqCase, &doMultQsqTest, QSQ_TEST_CASES },
+    [KT_MAIN_CTX]   = { "asmMainCtx", (kernelFunc)asmMainCtx, checkMainCtxCase, &doAsmMainCtxTest },
+    [KT_MAIN_SAT]   = { "asmMainSat", (kernelFunc)asmMainSat, checkMainSatCase, &doAsmMainSatTest },
+    [KT_DOT16]      = { "asmDot16",   (kernelFunc)asmDot16,   checkDot16Case,   &doDot16Test },
+    [KT_MAC16]      = { "asmMac16",   (kernelFunc)asmMac16,   checkMac16Case,   &doDot16Test },
+    [KT_Q15]        = { "asmQ15",     (kernelFunc)q15Group,   checkQ15Case,     &doQ15Test, Q15_TEST_CASES },
+    [KT_CMUL]       = { "asmCmul",    (kernelFunc)asmCmul,    checkCmulCase,    &doCmulTest, CMUL_TEST_CASES },
+    [KT_CMUL_CONJ]  = { "asmCmulConj", (kernelFunc)asmCmulConj, checkCmulConjCase, &doCmulTest, CMUL_TEST_CASES },
+    [KT_MULT_N]     = { "asmMultN",   (kernelFunc)asmMultN,   checkMultNCase,   &doMultNTest, MULTN_TEST_CASES },
+    [KT_KARATSUBA]  = { "Karatsuba",  (kernelFunc)multNKaratsuba, checkKaratsubaCase, &doMultNTest, MULTN_TEST_CASES },
+    [KT_PUKCC_MULT] = { "pukccMultN", (kernelFunc)pukccMultN, checkPukccMultCase, &doPukccTest, PUKCC_TEST_CASES },
+    [KT_PUKCC_MOD_MULT] = { "pukccModMultN", (kernelFunc)pukccModMultN, checkPukccModMultCase, &doPukccTest, PUKCC_TEST_CASES },
+    [KT_DIV]        = { "asmDiv",     (kernelFunc)divGroup,   checkDivCase,     &doDivTest, DIV_TEST_CASES },
+    [KT_UDIV_CONST] = { "asmUDivConst", (kernelFunc)asmUDivConst, checkUDivConstCase, &doDivTest, DIV_CONST_TEST_CASES },
+    [KT_UDIV_CONST_N] = { "asmUDivConstN", (kernelFunc)asmUDivConstN, checkUDivConstNCase, &doDivTest, DIV_CONST_TEST_CASES },
+    [KT_FIR]        = { "firProcess", (kernelFunc)firProcess, checkFirCase,     &doFirTest, FIR_TEST_CASES },
+};
+static kernelTestResults kernelResults[NUM_KERNEL_TESTS];
+
 
 // set this to 0 if using the simulator. BUT note that the simulator
 // does NOT support the UART, so there's no way to print output.
@@ -149,8 +250,35 @@ static void usartDmaChannelHandler(DMAC_TRANSFER_EVENT event, uintptr_t contextH
         isUSARTTxComplete = true;
     }
 }
+
+// SW0 on the Curiosity Nano is PA15, low when pressed. The pin isn't
+// set up by MCC, so make it an input with a pull-up here.
+static bool sw0Held(void)
+{
+    PORT_REGS->GROUP[0].PORT_DIRCLR = ((uint32_t)1U << 15U);
+    PORT_REGS->GROUP[0].PORT_OUTSET = ((uint32_t)1U << 15U);
+    PORT_REGS->GROUP[0].PORT_PINCFG[15] = PORT_PINCFG_INEN_Msk | PORT_PINCFG_PULLEN_Msk;
+    // give the pull-up time to charge the pin
+    for (volatile uint32_t i = 0; i < 1000; ++i);
+    return (((PORT_REGS->GROUP[0].PORT_IN >> 15U) & 0x01U) == 0);
+}
+#else
+static bool sw0Held(void)
+{
+    return false;
+}
 #endif
 
+// the kernel cycle counts from microBenchRun, for benchStoreBoot
+static void addMicroBench(benchRun *run, const microBenchResult *mb, uint32_t n)
+{
+    // mb[0] is the timing overhead, not a kernel
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        benchRunAdd(run, mb[i].name, BENCH_KIND_CYCLES, mb[i].medCycles);
+    }
+}
+
 
 
 // *****************************************************************************
@@ -174,470 +302,198 @@ int main ( void )
     isRTCExpired = true;
     isUSARTTxComplete = true;
 #endif //SIMULATOR
+
+    // micro-benchmark mode: the records and nothing else, so a PC can
+    // capture them and compare builds
+    if ((microBenchMode == true) || (sw0Held() == true))
+    {
+        static microBenchResult mb[MICRO_BENCH_MAX_RESULTS];
+        uint32_t numMb = microBenchAll(mb, MICRO_BENCH_MAX_RESULTS, &isUSARTTxComplete);
+        if (doBenchStore == true)
+        {
+            static benchRun run;
+            benchRunReset(&run);
+            addMicroBench(&run, mb, numMb);
+            benchStoreBoot(&run, BENCH_STORE_THRESHOLD_PCT, benchStoreRebase,
+                    &isUSARTTxComplete);
+        }
+        return ( EXIT_FAILURE ); // stop, same as after the tests
+    }
     
     printGlobalAddresses((char *)uartTxBuffer, &isUSARTTxComplete);
 
     // initialize all the variables
-    int32_t passCount = 0;
-    int32_t failCount = 0;
-    // int32_t x1 = sizeof(tc);
-    // int32_t x2 = sizeof(tc[0]);
-    uint32_t numTestCases = sizeof(tc)/sizeof(tc[0]);
+    uint32_t numTestCases = NUM_TEST_CASES;
     
-    static expectedValues exp;
+    // expected results for every tc[] case, computed once up front
+    // instead of once per case in every test loop
+    static expectedValues tcExpected[NUM_TEST_CASES];
+    calcExpectedValuesN(tc, numTestCases, tcExpected);
+
+    // the PUKCC self test, once, and only if the PUKCC rows run: it
+    // jumps into the PUKCL ROM, and a hang there would stop every test
+    bool pukccHw = false;
+    if (doPukccTest == true)
+    {
+        pukccHw = pukccInit();
+    }
 
     // Loop forever
     while ( true )
     {
-        // Do the tests for asmUnpack
-        int32_t unpackTotalPassCount = 0;
-        int32_t unpackTotalFailCount = 0;
-        int32_t unpackTotalTests = 0;
-
-        if (doUnpackTest == true)
+        // every kernel test; the totals for kernelTests[k] end up in
+        // kernelResults[k]. The PUKCC rows use the coprocessor only if
+        // its self test passed.
+        runKernelTests(kernelTests, kernelResults, NUM_KERNEL_TESTS,
+                tcExpected, numTestCases, onlyPrintFails, turboTests,
+                &isRTCExpired, &isUSARTTxComplete);
+        isUSARTTxComplete = false;
+
+        if (doPukccTest == true)
         {
-
-            for (int testCase = 0; testCase < numTestCases; ++testCase)
-            {
-                // Toggle the LED to show we're running a new test case
-                LED0_Toggle();
-
-                // reset the state variables for the timer and serial port funcs
-                isRTCExpired = false;
-                isUSARTTxComplete = false;
-                passCount = 0;
-                failCount = 0;
-                
-                // Get the packed value for this test case 
-                int32_t packedValue = tc[testCase];  // multiplicand and multiplier
-                calcExpectedValues(testCase,"",packedValue,&exp);
-                
-                int32_t unpackedA = 0;
-                int32_t unpackedB = 0;
-                
-                // !!!! THIS IS WHERE YOUR ASSEMBLY LANGUAGE PROGRAM GETS CALLED!!!!
-                // Call our assembly function defined in file asmMult.s
-                // Send in the test case value, see if the results are correct
-                asmUnpack(exp.packedVal, &unpackedA, &unpackedB);
-                
-                testAsmUnpack(testCase,
-                        "",
-                        exp.packedVal, // inputs
-                        &unpackedA,     // outputs
-                        &unpackedB,
-                        exp.inputA,    // expected values
-                        exp.inputB,
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-                // print summary of tests executed so far
-                unpackTotalPassCount = unpackTotalPassCount + passCount;
-                unpackTotalFailCount = unpackTotalFailCount + failCount;
-                unpackTotalTests = unpackTotalPassCount + unpackTotalFailCount;
-
-                isUSARTTxComplete = false;
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                        "========= asmUnpack In-progress test summary:\r\n"
-                        "%ld of %ld tests passed so far...\r\n"
-                        "\r\n",
-                        unpackTotalPassCount, unpackTotalTests); 
-                
-                printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-
-                // spin here until the LED toggle timer has expired. This allows
-                // the test cases to be spread out in time.
-                while (isRTCExpired == false);
-            } // end: loop on all test cases for asmUnpack
-            isUSARTTxComplete = false;
             snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= asmUnpack TESTS COMPLETE: \r\n"
-                    "Summary of tests: %ld of %ld tests passed\r\n"
+                    "========= PUKCC self test: %s, PUKCL version 0x%08" PRIx32 "; "
+                    "%" PRIu32 " PUKCC calls, %" PRIu32 " PUKCC errors\r\n"
                     "\r\n",
-                    unpackTotalPassCount, unpackTotalTests); 
+                    pukccHw ? "passed"
+                        : (PUKCC_USE_HW ? "FAILED, software only"
+                            : "not built (PUKCC_USE_HW is 0), software only"),
+                    pukccVersion,
+                    pukccHwCalls, pukccErrors);
+            printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
+            isUSARTTxComplete = false;
+        }
+        else
+        {
+            snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
+                    "========= PUKCC self test: not run\r\n"
+                    "\r\n");
             printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
+            isUSARTTxComplete = false;
+        }
 
-            // STUDENTS: put a breakpoint at the next instruction to see the 
-            // results of the asmUnpack tests!
+        // asmMainBatch on random packed values, reproducible from the seed
+        if (doRandomTest == true)
+        {
+            static sweepResults random;
+            randomPackedTests(asmMainBatch, "asmMainBatch", RANDOM_TEST_SEED,
+                    RANDOM_TEST_BATCHES, &random, &isUSARTTxComplete);
             isUSARTTxComplete = false;
-        } // if doUnpackTest == true
+        }
 
+        // asmMainBatch on the whole packed input space, or every
+        // SWEEP_STRIDE-th value of it
+        if (doSweepTest == true)
+        {
+            static sweepResults sweep;
+            sweepPackedInputs(asmMainBatch, "asmMainBatch", SWEEP_STRIDE,
+                    &sweep, &isUSARTTxComplete);
+            isUSARTTxComplete = false;
+        }
 
-        int32_t absTotalPassCount = 0;
-        int32_t absTotalFailCount = 0;
-        int32_t absTotalTests = 0;
-        if (doAbsTest == true)
+        if (doMultBench == true)
         {
-            // Do the tests for asmAbs
-            for (int testCase = 0; testCase < numTestCases; ++testCase)
-            {
-                // Toggle the LED to show we're running a new test case
-                LED0_Toggle();
-
-                // reset the state variables for the timer and serial port funcs
-                isRTCExpired = false;
-                isUSARTTxComplete = false;
-
-                passCount = 0;
-                failCount = 0;
-                
-                // Get the packed value for this test case 
-                int32_t packedValue = tc[testCase];  // multiplicand and multiplier
-                calcExpectedValues(testCase,"",packedValue,&exp);
-                
-                int32_t absA = 0;
-                int32_t absB = 0;
-                int32_t signBitA = 0;
-                int32_t signBitB = 0;
-                
-                // test the absolute value of A
-                int32_t r0_absValA = asmAbs(exp.inputA, &absA, &signBitA);
-
-                testAsmAbs(testCase,
-                        "",
-                        exp.inputA,  //inputs
-                        &absA,        // I/O
-                        &signBitA,
-                        r0_absValA,   // outputs
-                        exp.absA,  // expected values
-                        exp.signA,
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-     
-                absTotalPassCount = absTotalPassCount + passCount;
-                absTotalFailCount = absTotalFailCount + failCount;
-
-                passCount = 0;
-                failCount = 0;
-                
-                // test the absolute value of B
-                int32_t r0_absValB = asmAbs(exp.inputB, &absB, &signBitB);
-
-                testAsmAbs(testCase,
-                        "",
-                        exp.inputB,  //inputs
-                        &absB,        // I/O
-                        &signBitB,
-                        r0_absValB,   // outputs
-                        exp.absB,  // expected values
-                        exp.signB,
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-
-                // print summary of tests executed so far. Sums both A and B tests
-                absTotalPassCount = absTotalPassCount + passCount;
-                absTotalFailCount = absTotalFailCount + failCount;
-                absTotalTests = absTotalPassCount + absTotalFailCount;
-
-                isUSARTTxComplete = false;
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                        "========= asmAbs In-progress test summary:\r\n"
-                        "%ld of %ld tests passed so far...\r\n"
-                        "\r\n",
-                        absTotalPassCount, absTotalTests); 
-                
-                printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-
-                // spin here until the LED toggle timer has expired. This allows
-                // the test cases to be spread out in time.
-                while (isRTCExpired == false);
-            } // end: loop on all test cases for asmAbs A and B
-            
+            benchAsmMult(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= asmAbs TESTS COMPLETE: \r\n"
-                    "Summary of tests: %ld of %ld tests passed\r\n"
-                    "\r\n",
-                    absTotalPassCount, absTotalTests); 
-            printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-            
-            // STUDENTS: put a breakpoint at the next instruction to see the 
-            // results of the asmAbs tests!
+        }
+        if (doBatchBench == true)
+        {
+            benchAsmMainBatch(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-        } //  if doAbsTest == true
-        
-       
-       
-        // test cases for asmMult function
-        int32_t multTotalPassCount = 0;
-        int32_t multTotalFailCount = 0;
-        int32_t multTotalTests = 0;
-        if (doMultTest == true)
+        }
+        if (doClzBench == true)
         {
-            /* return product of two positive integers guaranteed to be <= 2^16 */
-            for (int testCase = 0; testCase < numTestCases; ++testCase)
-            {
-                // Toggle the LED to show we're running a new test case
-                LED0_Toggle();
-
-                // reset the state variables for the timer and serial port funcs
-                isRTCExpired = false;
-                isUSARTTxComplete = false;
-                
-                passCount = 0;
-                failCount = 0;
-                    // Get the packed value for this test case 
-                int32_t packedValue = tc[testCase];  // multiplicand and multiplier
-                calcExpectedValues(testCase,"",packedValue,&exp);
-                
-                // !!!! THIS IS WHERE YOUR ASSEMBLY LANGUAGE PROGRAM GETS CALLED!!!!
-                // Call our assembly function defined in file asmMult.s
-                // initConservedRegs(conservedRegInitValues);            // set the input values 
-                int32_t r0_initProd = asmMult(exp.absA, exp.absB);
-
-                testAsmMult(testCase,
-                        "",
-                        exp.absA, // inputs
-                        exp.absB,
-                        r0_initProd, // outputs
-                        exp.initProduct, // expected values
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-                
-                multTotalPassCount = multTotalPassCount + passCount;
-                multTotalFailCount = multTotalFailCount + failCount;
-                multTotalTests = multTotalPassCount + multTotalFailCount;
-
-                isUSARTTxComplete = false;
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                        "========= asmMult In-progress test summary:\r\n"
-                        "%ld of %ld tests passed so far...\r\n"
-                        "\r\n",
-                        multTotalPassCount, multTotalTests); 
-                
-                printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-
-                // spin here until the LED toggle timer has expired. This allows
-                // the test cases to be spread out in time.
-                while (isRTCExpired == false);
-            } // end: loop on all test cases for asmMult
-            
+            benchAsmMultClz(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= asmMult TESTS COMPLETE: \r\n"
-                    "Summary of tests: %ld of %ld tests passed\r\n"
-                    "\r\n",
-                    multTotalPassCount, multTotalTests); 
-            printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-            
-            // STUDENTS: put a breakpoint at the next instruction to see the 
-            // results of the asmMult tests!
+        }
+        if (doMultNBench == true)
+        {
+            benchMultN(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            
-        } // end -- if doMultTest == true
-
-
-        
-        // test cases for asmFixSign function
-        int32_t fsTotalPassCount = 0;
-        int32_t fsTotalFailCount = 0;
-        int32_t fsTotalTests = 0;
-        if (doFixSignTest == true)
+        }
+        if (doDivBench == true)
         {
-            for (int testCase = 0; testCase < numTestCases; ++testCase)
-            {
-                // Toggle the LED to show we're running a new test case
-                LED0_Toggle();
-
-                // reset the state variables for the timer and serial port funcs
-                isRTCExpired = false;
-                isUSARTTxComplete = false;
-                
-                passCount = 0;
-                failCount = 0;
-                // Get the packed value for this test case 
-                int32_t packedValue = tc[testCase];  // multiplicand and multiplier
-                calcExpectedValues(testCase,"",packedValue,&exp);
-                
-                // !!!! THIS IS WHERE YOUR ASSEMBLY LANGUAGE PROGRAM GETS CALLED!!!!
-                /* return corrected product based on signs of two original input values */
-                // provide the correct value as inputs,
-                // see if the sign is adjusted correctly
-                int32_t r0_finalProduct = asmFixSign(exp.initProduct, 
-                        exp.signA, 
-                        exp.signB);
-
-                testAsmFixSign(testCase,
-                        "DEBUG",
-                        exp.initProduct, // inputs
-                        exp.signA, 
-                        exp.signB,
-                        r0_finalProduct, // outputs
-                        exp.finalProduct, // expected values
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-                fsTotalPassCount = fsTotalPassCount + passCount;
-                fsTotalFailCount = fsTotalFailCount + failCount;
-                fsTotalTests = fsTotalPassCount + fsTotalFailCount;
-
-                isUSARTTxComplete = false;
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                        "========= asmFixSign In-progress test summary:\r\n"
-                        "%ld of %ld tests passed so far...\r\n"
-                        "\r\n",
-                        fsTotalPassCount, fsTotalTests); 
-                
-                printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-
-                // spin here until the LED toggle timer has expired. This allows
-                // the test cases to be spread out in time.
-                while (isRTCExpired == false);
-            } // end: loop on all test cases for asmFixSign
-            
+            benchDiv(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= asmFixSign TESTS COMPLETE: \r\n"
-                    "Summary of tests: %ld of %ld tests passed\r\n"
-                    "\r\n",
-                    fsTotalPassCount, fsTotalTests); 
-            printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-            
-            // STUDENTS: put a breakpoint at the next instruction to see the 
-            // results of the asmFixSign tests!
+        }
+        if (doQsqBench == true)
+        {
+            benchAsmMultQsq(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            
-        } // end -- if doFixSignTest == true
-
-
-
-       
-        // test cases for asmMain function
-        int32_t mainTotalPassCount = 0;
-        int32_t mainTotalFailCount = 0;
-        int32_t mainTotalTests = 0;
-        if (doAsmMainTest == true)
+        }
+        if (doFirBench == true)
         {
-            // return product of two positive integers guaranteed to be <= 2^16 
-            for (int testCase = 0; testCase < numTestCases; ++testCase)
-            {
-                // Toggle the LED to show we're running a new test case
-                LED0_Toggle();
-
-                // reset the state variables for the timer and serial port funcs
-                isRTCExpired = false;
-                isUSARTTxComplete = false;
-                passCount = 0;
-                failCount = 0;
-
-                // Get the packed value for this test case 
-                int32_t packedValue = tc[testCase];  // multiplicand and multiplier
-                calcExpectedValues(testCase,"",packedValue,&exp);
-                
-                // !!!! THIS IS WHERE YOUR ASSEMBLY LANGUAGE PROGRAM GETS CALLED!!!!
-                // Call our assembly function defined in file asmMult.s
-                
-                int32_t r0_mainFinalProd = asmMain(packedValue);
-                testAsmMain(testCase,
-                        "",
-                        exp.packedVal, // inputs
-                        r0_mainFinalProd, // outputs
-                        a_Multiplicand, // val stored in mem
-                        b_Multiplier,  // val stored in mem
-                        a_Abs, a_Sign, b_Abs, b_Sign,
-                        init_Product,
-                        final_Product,
-                        &exp, // expected values
-                        &passCount,
-                        &failCount,
-                        onlyPrintFails,
-                        &isUSARTTxComplete
-                        );
-
-                            
-                mainTotalPassCount = mainTotalPassCount + passCount;
-                mainTotalFailCount = mainTotalFailCount + failCount;
-                mainTotalTests = mainTotalPassCount + mainTotalFailCount;
-
-                isUSARTTxComplete = false;
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                        "========= asmMain In-progress test summary:\r\n"
-                        "%ld of %ld tests passed so far...\r\n"
-                        "\r\n",
-                        mainTotalPassCount, mainTotalTests); 
-                
-                printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
-
-                // spin here until the LED toggle timer has expired. This allows
-                // the test cases to be spread out in time.
-                while (isRTCExpired == false);
-            } // end: loop on all test cases for asmMult
-            
+            benchFir(&isUSARTTxComplete);
             isUSARTTxComplete = false;
-            snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= asmMain TESTS COMPLETE: \r\n"
-                    "Summary of tests: %ld of %ld tests passed\r\n"
-                    "\r\n",
-                    mainTotalPassCount, mainTotalTests); 
-            printAndWait((char*)uartTxBuffer,&isUSARTTxComplete);
+        }
 
-            // STUDENTS: put a breakpoint at the next instruction to see the 
-            // results of the asmMain tests!
+        // this boot's pass counts and kernel cycles vs the stored baseline
+        if (doBenchStore == true)
+        {
+            static microBenchResult mb[MICRO_BENCH_MAX_RESULTS];
+            static benchRun run;
+            benchRunReset(&run);
+            for (uint32_t k = 0; k < NUM_KERNEL_TESTS; ++k)
+            {
+                benchRunAdd(&run, kernelTests[k].name, BENCH_KIND_PASSES,
+                        kernelResults[k].passCount);
+            }
+            addMicroBench(&run, mb, microBenchRun(mb, MICRO_BENCH_MAX_RESULTS));
+            benchStoreBoot(&run, BENCH_STORE_THRESHOLD_PCT, benchStoreRebase,
+                    &isUSARTTxComplete);
             isUSARTTxComplete = false;
-        } // end -- if doAsmMainTest == true
+        }
         
         // When all test cases are complete, print the pass/fail statistics
         // Keep looping so that students can see code is still running.
         // We do this in case there are very few tests and they don't have the
         // terminal hooked up in time.
         uint32_t idleCount = 1;
-        // uint32_t totalTests = totalPassCount + totalFailCount;
         bool firstTime = true;
-        // float unpackPct, absPct, multPct, fsPct, mainPct;
-        uint32_t unpackPts, absPts, multPts, fsPts, mainPts,totalPts;
-        unpackPts = 5*unpackTotalPassCount/unpackTotalTests;
-        absPts = 5*absTotalPassCount/absTotalTests;
-        multPts = 5*multTotalPassCount/multTotalTests;
-        fsPts = 5*fsTotalPassCount/fsTotalTests;
-        mainPts = 5*mainTotalPassCount/mainTotalTests;
-        totalPts = unpackPts + absPts + multPts + fsPts + mainPts;
+        // 5 pts per lab kernel, scaled by the fraction of its tests that passed
+        uint32_t kernelPts[NUM_LAB_KERNELS];
+        uint32_t totalPts = 0;
+        bool allKernelsTested = true;
+        for (uint32_t k = 0; k < NUM_LAB_KERNELS; ++k)
+        {
+            kernelPts[k] = 0;
+            if (kernelResults[k].numTests != 0)
+            {
+                kernelPts[k] = 5*kernelResults[k].passCount/kernelResults[k].numTests;
+            }
+            totalPts = totalPts + kernelPts[k];
+            allKernelsTested = allKernelsTested && *kernelTests[k].enabled;
+        }
         
         while(true)      // post-test forever loop
         {
             isRTCExpired = false;
             isUSARTTxComplete = false;
-            if (doUnpackTest == true && 
-                    doAbsTest == true && 
-                    doMultTest == true &&
-                    doFixSignTest == true &&
-                    doAsmMainTest == true)
+            if (allKernelsTested == true)
             {
-                snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
-                    "========= %s: Functions Lab ALL TESTS COMPLETE: Post-test Idle Cycle Number: %ld\r\n"
-                    "Summary of tests: asmUnpack:  %ld of %ld tests passed; %ld pts\r\n"
-                    "Summary of tests: asmAbs:     %ld of %ld tests passed; %ld pts\r\n"
-                    "Summary of tests: asmMult:    %ld of %ld tests passed; %ld pts\r\n"
-                    "Summary of tests: asmFixSign: %ld of %ld tests passed; %ld pts\r\n"
-                    "Summary of tests: asmMain:    %ld of %ld tests passed; %ld pts\r\n"
-                    " Total point score: %ld\r\n"
+                int len = snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
+                    "========= %s: Functions Lab ALL TESTS COMPLETE: Post-test Idle Cycle Number: %" PRIu32 "\r\n",
+                    (char *)(uintptr_t)nameStrPtr, idleCount);
+                for (uint32_t k = 0; k < NUM_LAB_KERNELS; ++k)
+                {
+                    len += snprintf((char*)uartTxBuffer + len, MAX_PRINT_LEN - len,
+                        "Summary of tests: %s:%*s%" PRId32 " of %" PRId32 " tests passed; %" PRIu32 " pts\r\n",
+                        kernelTests[k].name,
+                        (int)(11 - strlen(kernelTests[k].name)), "",
+                        kernelResults[k].passCount, kernelResults[k].numTests,
+                        kernelPts[k]);
+                }
+                snprintf((char*)uartTxBuffer + len, MAX_PRINT_LEN - len,
+                    " Total point score: %" PRIu32 "\r\n"
                     "\r\n",
-                    (char *) nameStrPtr, idleCount, 
-                    unpackTotalPassCount, unpackTotalTests, unpackPts,
-                    absTotalPassCount, absTotalTests, absPts,
-                    multTotalPassCount, multTotalTests, multPts,
-                    fsTotalPassCount, fsTotalTests, fsPts,
-                    mainTotalPassCount, mainTotalTests, mainPts,
-                    totalPts
-                    ); 
+                    totalPts);
             }
             else
             {
                 snprintf((char*)uartTxBuffer, MAX_PRINT_LEN,
                     "========= %s: PARTIAL tests complete, make sure to rerun with all tests enabled!!!\r\n"
-                    "Post-test Idle Cycle Number: %ld\r\n",
-                    (char *) nameStrPtr, idleCount);
+                    "Post-test Idle Cycle Number: %" PRIu32 "\r\n",
+                    (char *)(uintptr_t)nameStrPtr, idleCount);
             }
 
 #if USING_HW 
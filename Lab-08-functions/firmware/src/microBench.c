@@ -0,0 +1,386 @@
+/* ************************************************************************** */
+/** Micro-benchmarks for every asm entry point
+
+  @File Name
+    microBench.c
+
+  @Summary
+    See microBench.h.
+
+  @Description
+    Each kernel is called through a small wrapper with its inputs in
+    statics, so every timed call goes through the same timeCall code.
+    The call overhead is timeCall on an empty wrapper, which is
+    everything between the two CYCCNT reads except the kernel; its min
+    cycles and median stall counts are taken off every sample. The min,
+    not the median, so no sample loses more than the timing really cost.
+ */
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Included Files                                                    */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stddef.h>                     // Defines NULL
+#include <stdbool.h>                    // Defines true
+#include <string.h>
+#include <inttypes.h>
+#include "definitions.h"                // SYS function prototypes
+#include "asmExterns.h"
+#include "benchFuncs.h"
+#include "microBench.h"
+#include "divConst.h"
+#include "firFilter.h"
+#include "printFuncs.h"  // lab print funcs
+#include "testFuncs.h"   // QSQ_OPERAND_BITS
+
+
+#define MAX_PRINT_LEN 1000
+
+// longest record, so the buffer is sent before it can overflow
+#define MAX_RECORD_LEN 100
+
+static uint8_t txBuffer[MAX_PRINT_LEN] = {0};
+
+// declared in main.c rather than asmExterns.h
+extern void asmUnpack(uint32_t packedValue, int32_t* a, int32_t* b);
+extern int32_t asmAbs(int32_t input, int32_t *absOut, int32_t *signBit);
+extern int32_t asmMult(int32_t a, int32_t b);
+extern int32_t asmFixSign(int32_t initProduct, int32_t signBitA, int32_t signBitB);
+extern int32_t asmMain(uint32_t packedValue);
+
+// block kernel in asmFir.s
+extern void asmFirBlock(const int16_t *in, int16_t *out, size_t n, firFilter *f);
+
+// counter deltas for one timed call
+typedef struct _dwtCounts
+{
+    uint32_t cycles;
+    uint32_t cpi;
+    uint32_t lsu;
+    uint32_t fold;
+} dwtCounts;
+
+typedef struct _microKernel
+{
+    const char *name;
+    void (*run)(void);
+} microKernel;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Kernel Inputs                                                     */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// the inputs are fixed so the records can be compared between builds.
+// Both halves negative, so the sign handling is exercised.
+static const uint32_t packedIn = 0xFFF3FFE0;
+// 15 bit magnitudes: close to the worst case for the shift-and-add loops
+static const int32_t multA = 0x7FF1;
+static const int32_t multB = 0x7FF2;
+// largest operands asmMultQsq takes
+static const int32_t qsqA = (1 << QSQ_OPERAND_BITS) - 1;
+static const int32_t qsqB = (1 << QSQ_OPERAND_BITS) - 2;
+// UDIV/SDIV time depends on the operands; a 32 bit by 4 bit divide
+static const int32_t divN = -123456789;
+static const int32_t divD = 7;
+
+static int32_t outA;
+static int32_t outB;
+static int32_t divRem;
+static uint32_t uDivRem;
+static mult_ctx_t ctx;
+static divMagic by10;
+static firFilter fir;
+static uint32_t xIn[MICRO_BENCH_LEN];
+static uint32_t yIn[MICRO_BENCH_LEN];
+static uint32_t wordOut[2 * MICRO_BENCH_LEN];
+static int16_t firIn[MICRO_BENCH_LEN];
+static int16_t firOut[MICRO_BENCH_LEN];
+static int16_t firTaps[MICRO_BENCH_LEN];
+static uint32_t firCoefBuf[FIR_COEF_WORDS(MICRO_BENCH_LEN)];
+static uint32_t firStateBuf[FIR_STATE_WORDS(MICRO_BENCH_LEN)];
+
+static void setupInputs(void)
+{
+    uint32_t seed = 0x6D696372;
+    for (uint32_t i = 0; i < MICRO_BENCH_LEN; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        xIn[i] = seed;
+        seed = seed * 1664525 + 1013904223;
+        yIn[i] = seed;
+        firIn[i] = (int16_t)(xIn[i] >> 16);
+        firTaps[i] = (int16_t)(yIn[i] >> 16) / MICRO_BENCH_LEN;
+    }
+    divMagicInit(&by10, 10);
+    firInit(&fir, firTaps, MICRO_BENCH_LEN, firCoefBuf, firStateBuf);
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Kernel Wrappers                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// timed as the call overhead
+static void runNothing(void)
+{
+}
+
+static void runUnpack(void)       { asmUnpack(packedIn, &outA, &outB); }
+static void runAbs(void)          { asmAbs(-multA, &outA, &outB); }
+static void runAbsPacked(void)    { asmAbsPacked(packedIn, &wordOut[0], &wordOut[1]); }
+static void runMult(void)         { asmMult(multA, multB); }
+static void runMultShiftAdd(void) { asmMultShiftAdd(multA, multB); }
+static void runMultHw(void)       { asmMultHw(multA, multB); }
+static void runMultClz(void)      { asmMultClz(multA, multB); }
+static void runFixSign(void)      { asmFixSign(multA * multB, 1, 0); }
+static void runMain(void)         { asmMain(packedIn); }
+static void runMainBatch(void)    { asmMainBatch(xIn, (int32_t *)wordOut, MICRO_BENCH_LEN); }
+static void runDot16(void)        { asmDot16(xIn, yIn, MICRO_BENCH_LEN); }
+static void runMac16(void)        { asmMac16(-1, xIn, yIn, MICRO_BENCH_LEN); }
+static void runMainCtx(void)      { asmMainCtx(packedIn, &ctx); }
+static void runMainSat(void)      { asmMainSat(packedIn); }
+static void runMultN(void)        { asmMultN(wordOut, xIn, yIn, MICRO_BENCH_LEN); }
+static void runQ15Mul(void)       { asmQ15Mul(xIn[0], yIn[0]); }
+static void runQ15Mac(void)       { asmQ15Mac(-1, xIn[0], yIn[0]); }
+static void runQ15Add(void)       { asmQ15Add(xIn[0], yIn[0]); }
+static void runQ15Sub(void)       { asmQ15Sub(xIn[0], yIn[0]); }
+static void runQ15Scale(void)     { asmQ15Scale(xIn[0], (int32_t)yIn[0]); }
+static void runCmul(void)         { asmCmul(xIn, yIn, wordOut, MICRO_BENCH_LEN); }
+static void runCmulConj(void)     { asmCmulConj(xIn, yIn, wordOut, MICRO_BENCH_LEN); }
+static void runDiv(void)          { asmDiv(divN, divD); }
+static void runMod(void)          { asmMod(divN, divD); }
+static void runDivMod(void)       { asmDivMod(divN, divD, &divRem); }
+static void runUDiv(void)         { asmUDiv((uint32_t)divN, divD); }
+static void runUMod(void)         { asmUMod((uint32_t)divN, divD); }
+static void runUDivMod(void)      { asmUDivMod((uint32_t)divN, divD, &uDivRem); }
+static void runUDivConst(void)    { asmUDivConst((uint32_t)divN, &by10); }
+static void runUDivConstN(void)   { asmUDivConstN(xIn, wordOut, MICRO_BENCH_LEN, &by10); }
+static void runMultQsq(void)      { asmMultQsq(qsqA, qsqB); }
+static void runFirBlock(void)     { asmFirBlock(firIn, firOut, MICRO_BENCH_LEN, &fir); }
+
+static const microKernel kernels[] = {
+    { "asmUnpack",       runUnpack },
+    { "asmAbs",          runAbs },
+    { "asmAbsPacked",    runAbsPacked },
+    { "asmMult",         runMult },
+    { "asmMultShiftAdd", runMultShiftAdd },
+    { "asmMultHw",       runMultHw },
+    { "asmMultClz",      runMultClz },
+    { "asmFixSign",      runFixSign },
+    { "asmMain",         runMain },
+    { "asmMainBatch",    runMainBatch },
+    { "asmDot16",        runDot16 },
+    { "asmMac16",        runMac16 },
+    { "asmMainCtx",      runMainCtx },
+    { "asmMainSat",      runMainSat },
+    { "asmMultN",        runMultN },
+    { "asmQ15Mul",       runQ15Mul },
+    { "asmQ15Mac",       runQ15Mac },
+    { "asmQ15Add",       runQ15Add },
+    { "asmQ15Sub",       runQ15Sub },
+    { "asmQ15Scale",     runQ15Scale },
+    { "asmCmul",         runCmul },
+    { "asmCmulConj",     runCmulConj },
+    { "asmDiv",          runDiv },
+    { "asmMod",          runMod },
+    { "asmDivMod",       runDivMod },
+    { "asmUDiv",         runUDiv },
+    { "asmUMod",         runUMod },
+    { "asmUDivMod",      runUDivMod },
+    { "asmUDivConst",    runUDivConst },
+    { "asmUDivConstN",   runUDivConstN },
+    { "asmMultQsq",      runMultQsq },
+    { "asmFirBlock",     runFirBlock },
+};
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// time one call of run. Not inlined, so the overhead measured with
+// runNothing is the same code as for the kernels.
+static void __attribute__((noinline)) timeCall(void (*run)(void), dwtCounts *d)
+{
+    uint32_t cpi = DWT->CPICNT;
+    uint32_t lsu = DWT->LSUCNT;
+    uint32_t fold = DWT->FOLDCNT;
+    uint32_t start = DWT->CYCCNT;
+    run();
+    d->cycles = DWT->CYCCNT - start;
+    d->cpi = (DWT->CPICNT - cpi) & DWT_CPICNT_CPICNT_Msk;
+    d->lsu = (DWT->LSUCNT - lsu) & DWT_LSUCNT_LSUCNT_Msk;
+    d->fold = (DWT->FOLDCNT - fold) & DWT_FOLDCNT_FOLDCNT_Msk;
+}
+
+// a - b, or 0 if b is bigger
+static uint32_t subFloor(uint32_t a, uint32_t b)
+{
+    return (a > b) ? (a - b) : 0;
+}
+
+// insertion sort; n is small
+static void sortSamples(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        uint32_t x = v[i];
+        uint32_t j = i;
+        while ((j > 0) && (v[j - 1] > x))
+        {
+            v[j] = v[j - 1];
+            --j;
+        }
+        v[j] = x;
+    }
+}
+
+// warm up, time MICRO_BENCH_REPS calls, and reduce them to *r. The
+// overhead is taken off every sample; pass NULL to get raw counts.
+static void benchKernel(const microKernel *k, const dwtCounts *overhead,
+        microBenchResult *r)
+{
+    static uint32_t cycles[MICRO_BENCH_REPS];
+    static uint32_t cpi[MICRO_BENCH_REPS];
+    static uint32_t lsu[MICRO_BENCH_REPS];
+    static uint32_t fold[MICRO_BENCH_REPS];
+    const dwtCounts none = { 0, 0, 0, 0 };
+    dwtCounts d;
+
+    if (overhead == NULL)
+    {
+        overhead = &none;
+    }
+    r->name = k->name;
+    r->calls = MICRO_BENCH_REPS;
+    r->wrapped = false;
+
+    __disable_irq();
+    for (uint32_t i = 0; i < MICRO_BENCH_WARMUP; ++i)
+    {
+        timeCall(k->run, &d);
+    }
+    for (uint32_t i = 0; i < MICRO_BENCH_REPS; ++i)
+    {
+        timeCall(k->run, &d);
+        if (d.cycles >= 256)
+        {
+            r->wrapped = true;
+        }
+        cycles[i] = subFloor(d.cycles, overhead->cycles);
+        cpi[i] = subFloor(d.cpi, overhead->cpi);
+        lsu[i] = subFloor(d.lsu, overhead->lsu);
+        fold[i] = subFloor(d.fold, overhead->fold);
+    }
+    __enable_irq();
+
+    sortSamples(cycles, MICRO_BENCH_REPS);
+    sortSamples(cpi, MICRO_BENCH_REPS);
+    sortSamples(lsu, MICRO_BENCH_REPS);
+    sortSamples(fold, MICRO_BENCH_REPS);
+    r->minCycles = cycles[0];
+    r->medCycles = cycles[MICRO_BENCH_REPS / 2];
+    r->maxCycles = cycles[MICRO_BENCH_REPS - 1];
+    r->cpiCycles = cpi[MICRO_BENCH_REPS / 2];
+    r->lsuCycles = lsu[MICRO_BENCH_REPS / 2];
+    r->foldInsns = fold[MICRO_BENCH_REPS / 2];
+}
+
+// add r's record to txBuffer at *len, sending the buffer first if it's
+// nearly full
+static void appendRecord(const microBenchResult *r, int *len,
+        volatile bool *txComplete)
+{
+    if (*len > MAX_PRINT_LEN - MAX_RECORD_LEN)
+    {
+        printAndWait((char *)txBuffer, txComplete);
+        *len = 0;
+    }
+    int32_t insns = (int32_t)(r->medCycles - r->cpiCycles - r->lsuCycles + r->foldInsns);
+    *len += snprintf((char*)txBuffer + *len, MAX_PRINT_LEN - *len,
+            "MB,%s,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRId32 ",%d\r\n",
+            r->name, r->calls, r->minCycles, r->medCycles, r->maxCycles,
+            r->cpiCycles, r->lsuCycles, r->foldInsns, insns,
+            r->wrapped ? 1 : 0);
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+void microBenchInit(void)
+{
+    benchInit();
+    DWT->CPICNT = 0;
+    DWT->LSUCNT = 0;
+    DWT->FOLDCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CPIEVTENA_Msk | DWT_CTRL_LSUEVTENA_Msk
+            | DWT_CTRL_FOLDEVTENA_Msk;
+}
+
+
+uint32_t microBenchRun(microBenchResult *results, uint32_t maxResults)
+{
+    static const microKernel nothing = { "overhead", runNothing };
+    dwtCounts overhead;
+    uint32_t n = 0;
+
+    if (maxResults == 0)
+    {
+        return 0;
+    }
+    setupInputs();
+    microBenchInit();
+
+    // the empty call: min cycles, median stall counts
+    benchKernel(&nothing, NULL, &results[n]);
+    overhead.cycles = results[n].minCycles;
+    overhead.cpi = results[n].cpiCycles;
+    overhead.lsu = results[n].lsuCycles;
+    overhead.fold = results[n].foldInsns;
+    ++n;
+
+    for (uint32_t k = 0; (k < NUM_KERNELS) && (n < maxResults); ++k)
+    {
+        benchKernel(&kernels[k], &overhead, &results[n]);
+        ++n;
+    }
+    return n;
+}
+
+
+uint32_t microBenchAll(microBenchResult *results, uint32_t maxResults,
+        volatile bool *txComplete)
+{
+    uint32_t n = microBenchRun(results, maxResults);
+
+    int len = snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "MB,kernel,calls,min,med,max,cpi,lsu,fold,insns,wrap\r\n");
+    // results[0] is the raw overhead; the others have it taken off
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        appendRecord(&results[i], &len, txComplete);
+    }
+    snprintf((char*)txBuffer + len, MAX_PRINT_LEN - len, "MB,end\r\n\r\n");
+    printAndWait((char *)txBuffer, txComplete);
+    return n;
+}
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,119 @@
+/* ************************************************************************** */
+/** Micro-benchmarks for every asm entry point
+
+  @File Name
+    microBench.h
+
+  @Summary
+    Per-call cycle and stall counts of each asm kernel, from the DWT.
+
+  @Description
+    Every kernel is warmed up, then called MICRO_BENCH_REPS times with
+    fixed inputs. Each call is timed with the DWT CYCCNT, CPICNT, LSUCNT
+    and FOLDCNT counters, less the cost of timing an empty call. The
+    results go out over the UART as one compact record per kernel:
+
+      MB,kernel,calls,min,med,max,cpi,lsu,fold,insns,wrap
+
+    The first record, "overhead", is that empty call, raw: the two
+    CYCCNT reads, the indirect call and the return. Its min cycles and
+    median stall counts come off every sample of the other records.
+    What is left in a kernel's numbers besides the kernel itself is its
+    wrapper: loading the inputs from statics, saving lr and the bl,
+    a few cycles that are the same from build to build.
+
+    min/med/max are cycles per call. cpi, lsu and fold are the medians
+    of the extra cycles spent in multi-cycle instructions, extra cycles
+    in loads/stores, and instructions folded into another one for free.
+    insns = med - cpi - lsu + fold, the instructions executed (interrupts
+    are off, so there are no exception or sleep cycles). The stall
+    counters are only 8 bits; wrap is 1 if a call took 256 cycles or
+    more, so its stall counts may have wrapped.
+    Meant to be captured by a PC and diffed between builds.
+ */
+/* ************************************************************************** */
+
+#ifndef _MICRO_BENCH_H    /* Guard against multiple inclusion */
+#define _MICRO_BENCH_H
+
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Constants
+    // *****************************************************************************
+    // *****************************************************************************
+
+// untimed calls before the timed ones, to fill the cache and prefetch buffer
+#define MICRO_BENCH_WARMUP 4
+
+// timed calls per kernel; odd, so the median is one of the samples
+#define MICRO_BENCH_REPS 31
+
+// results from microBenchRun: the overhead, then one per kernel
+#define MICRO_BENCH_MAX_RESULTS 40
+
+// length of the array arguments. Small enough that most kernels stay
+// under 256 cycles, where the 8 bit stall counters can't wrap.
+#define MICRO_BENCH_LEN 8
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Data Types
+    // *****************************************************************************
+    // *****************************************************************************
+
+// one record: per-call counts for one kernel, call overhead removed
+typedef struct _microBenchResult
+{
+    const char *name;
+    uint32_t calls;
+    uint32_t minCycles;
+    uint32_t medCycles;
+    uint32_t maxCycles;
+    uint32_t cpiCycles;    // medians of the DWT stall counters
+    uint32_t lsuCycles;
+    uint32_t foldInsns;
+    bool wrapped;          // a call took >= 256 cycles; stall counts may be low
+} microBenchResult;
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Interface Functions
+    // *****************************************************************************
+    // *****************************************************************************
+
+// enable CYCCNT and the CPI, LSU and fold counters. Safe to call more
+// than once.
+void microBenchInit(void);
+
+// benchmark every asm kernel into results[0..n) and return n, at most
+// maxResults. results[0] is the call overhead itself, not taken off
+// anything; results[1..n) have results[0].minCycles and its median
+// stall counts taken off. Each kernel runs with interrupts off;
+// prints nothing.
+uint32_t microBenchRun(microBenchResult *results, uint32_t maxResults);
+
+// microBenchRun, then send one record per result, between a header
+// record and an "MB,end" record. Returns n.
+uint32_t microBenchAll(microBenchResult *results, uint32_t maxResults,
+        volatile bool *txComplete);
+
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MICRO_BENCH_H */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/** Multi-precision unsigned multiply
+
+  @File Name
+    multN.c
+
+  @Summary
+    Karatsuba driver on top of the asmMultN schoolbook kernel.
+
+  @Description
+    Splits a and b into a low half of m limbs and a high half of
+    h = n - m limbs (h >= m), then
+      z0 = a0*b0, z2 = a1*b1, z1 = (a0+a1)(b0+b1) - z0 - z2
+      a*b = z2 * 2^(64m) + z1 * 2^(32m) + z0
+    z0 and z2 go straight into the result; z1 is built in scratch.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "multN.h"
+
+size_t multNThreshold = MULTN_DEFAULT_THRESHOLD;
+
+// schoolbook kernel in asmMult.s
+extern void asmMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+// out[0..xLen) = x[0..xLen) + y[0..yLen), yLen <= xLen. Returns the carry.
+static uint32_t addN(uint32_t *out, const uint32_t *x, size_t xLen,
+        const uint32_t *y, size_t yLen)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < xLen; ++i)
+    {
+        carry += x[i];
+        if (i < yLen)
+        {
+            carry += y[i];
+        }
+        out[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return (uint32_t)carry;
+}
+
+// x[0..xLen) += y[0..yLen), carry rippling up to the end of x.
+// Anything that would carry out of x is dropped; callers only use this
+// where the math says the sum fits.
+static void addInto(uint32_t *x, size_t xLen, const uint32_t *y, size_t yLen)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < xLen; ++i)
+    {
+        carry += x[i];
+        if (i < yLen)
+        {
+            carry += y[i];
+        }
+        else if (carry == x[i])
+        {
+            break;   // no more carry and nothing left to add
+        }
+        x[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+}
+
+// x[0..xLen) -= y[0..yLen), yLen <= xLen. The result must not go negative.
+static void subFrom(uint32_t *x, size_t xLen, const uint32_t *y, size_t yLen)
+{
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < xLen; ++i)
+    {
+        uint32_t sub = (i < yLen) ? y[i] : 0;
+        if ((i >= yLen) && (borrow == 0))
+        {
+            break;
+        }
+        uint64_t diff = (uint64_t)x[i] - sub - borrow;
+        x[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63);
+    }
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+size_t multNKaratsubaScratchLimbs(size_t n, size_t threshold)
+{
+    if ((n < 2) || (n < threshold))
+    {
+        return 0;
+    }
+    size_t h = n - n / 2;
+    // sa, sb (h each) and z1 (2h + 2), plus the deepest recursion
+    return 4 * h + 2 + multNKaratsubaScratchLimbs(h, threshold);
+}
+
+
+void multNKaratsuba(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n,
+        uint32_t *scratch, size_t threshold)
+{
+    if ((n < 2) || (n < threshold))
+    {
+        asmMultN(r, a, b, n);
+        return;
+    }
+
+    size_t m = n / 2;
+    size_t h = n - m;
+    uint32_t *sa = scratch;
+    uint32_t *sb = sa + h;
+    uint32_t *z1 = sb + h;
+    uint32_t *next = z1 + 2 * h + 2;
+
+    // z0 and z2 go straight into the low and high part of the result
+    multNKaratsuba(r, a, b, m, next, threshold);
+    multNKaratsuba(r + 2 * m, a + m, b + m, h, next, threshold);
+
+    // (a0 + a1) and (b0 + b1) are h limbs plus a carry bit each
+    uint32_t ca = addN(sa, a + m, h, a, m);
+    uint32_t cb = addN(sb, b + m, h, b, m);
+
+    // z1 = (sa + ca*B^h)(sb + cb*B^h), B = 2^32
+    multNKaratsuba(z1, sa, sb, h, next, threshold);
+    z1[2 * h] = 0;
+    z1[2 * h + 1] = 0;
+    if (ca != 0)
+    {
+        addInto(z1 + h, h + 2, sb, h);
+    }
+    if (cb != 0)
+    {
+        addInto(z1 + h, h + 2, sa, h);
+    }
+    if ((ca != 0) && (cb != 0))
+    {
+        addInto(z1 + 2 * h, 2, &ca, 1);
+    }
+
+    // z1 -= z0 + z2, then add it in at B^m
+    subFrom(z1, 2 * h + 2, r, 2 * m);
+    subFrom(z1, 2 * h + 2, r + 2 * m, 2 * h);
+    addInto(r + m, 2 * n - m, z1, 2 * h + 2);
+}
+
+
+size_t multNScratchLimbs(size_t n)
+{
+    return multNKaratsubaScratchLimbs(n, multNThreshold);
+}
+
+
+void multN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n,
+        uint32_t *scratch)
+{
+    multNKaratsuba(r, a, b, n, scratch, multNThreshold);
+}
+
+/* *****************************************************************************
+ End of File
+ */
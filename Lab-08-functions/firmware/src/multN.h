@@ -0,0 +1,59 @@
+/* ************************************************************************** */
+/** Multi-precision unsigned multiply
+
+  @File Name
+    multN.h
+
+  @Summary
+    a * b for unsigned integers of any number of 32 bit words.
+
+  @Description
+    Numbers are arrays of uint32_t "limbs", least significant word first.
+    Below multNThreshold limbs the product is done by the UMAAL
+    schoolbook loop asmMultN in asmMult.s; above it, Karatsuba splits
+    the operands in half and recurses.
+ */
+/* ************************************************************************** */
+
+#ifndef _MULT_N_H    /* Guard against multiple inclusion */
+#define _MULT_N_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// default for multNThreshold. benchMultN (benchFuncs.c) measures the
+// real crossover on the board.
+#define MULTN_DEFAULT_THRESHOLD 32
+
+// operands with at least this many limbs use Karatsuba
+extern size_t multNThreshold;
+
+// number of scratch limbs multN needs for n limb operands
+// (0 if n is below multNThreshold)
+size_t multNScratchLimbs(size_t n);
+
+// r[0..2n) = a[0..n) * b[0..n). r must not overlap a or b.
+// scratch must hold multNScratchLimbs(n) limbs (may be NULL if that is 0).
+void multN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n,
+        uint32_t *scratch);
+
+// same as multN but with an explicit threshold, for benchmarking
+size_t multNKaratsubaScratchLimbs(size_t n, size_t threshold);
+void multNKaratsuba(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n,
+        uint32_t *scratch, size_t threshold);
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MULT_N_H */
+
+/* *****************************************************************************
+ End of File
+ */
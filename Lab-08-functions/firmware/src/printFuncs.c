@@ -89,6 +89,22 @@ void printAndWait(char *txBuffer, volatile bool *txCompletePtr)
 
 }
 
+// same as printAndWait, but returns as soon as the DMA transfer starts.
+// Used for progress lines in loops that shouldn't stall on the UART.
+void printNoWait(char *txBuffer, volatile bool *txCompletePtr)
+{
+    *txCompletePtr = false;
+
+#if USING_HW 
+    DMAC_ChannelTransfer(DMAC_CHANNEL_0, txBuffer, \
+        (const void *)&(SERCOM5_REGS->USART_INT.SERCOM_DATA), \
+        strlen((const char*)txBuffer));
+#else
+    *txCompletePtr = true;
+#endif
+
+}
+
 // print the mem addresses of the global vars at startup
 // this is to help the students debug their code
 void printGlobalAddresses(char *txBuffer, volatile bool *txComplete)
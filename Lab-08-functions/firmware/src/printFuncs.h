@@ -157,6 +157,9 @@ extern "C" {
      */
 
     void printAndWait(char *txBuffer, volatile bool *txCompletePtr);
+    // start the DMA print and return right away. *txCompletePtr goes true
+    // when it's done; txBuffer must not change until then.
+    void printNoWait(char *txBuffer, volatile bool *txCompletePtr);
     void printGlobalAddresses(char *uartTxBuffer, volatile bool *txCompletePtr);
     /* Provide C++ Compatibility */
 #ifdef __cplusplus
@@ -0,0 +1,404 @@
+/* ************************************************************************** */
+/** Wide multiply on the PUKCC crypto coprocessor
+
+  @File Name
+    pukccMult.c
+
+  @Summary
+    Size-based dispatch between multN and the PUKCL Fmult service, and
+    a Barrett modular multiply built on it.
+
+  @Description
+    Crypto RAM layout for one Fmult call, n words per operand:
+      X at 0, Y after X, R after Y; each area has PUKCC_PAD_BYTES of
+      zero padding after it.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pukccMult.h"
+#include "multN.h"
+
+#ifdef PUKCC_HOST_SIM
+#define PUKCC_CRYPTO_RAM ((uint8_t *)pukccSimCryptoRam)
+#define PUKCCSR          pukccSimCsr
+#define PUKCL_PROCESS(p) pukccSimProcess(p)
+#else
+#include "definitions.h"                // SYS function prototypes
+#define PUKCC_CRYPTO_RAM ((uint8_t *)PUKCC_CRYPTO_RAM_ADDR)
+#define PUKCCSR          (*(volatile uint32_t *)PUKCC_CSR_ADDR)
+#define PUKCL_PROCESS(p) (((void (*)(pukclParams *))PUKCL_ROM_ENTRY)(p))
+#endif
+
+// X, Y and R of an n + 1 word Fmult, with their padding
+_Static_assert(4 * 4 * (PUKCC_MAX_LIMBS + 1) + 3 * PUKCC_PAD_BYTES
+        <= PUKCC_CRYPTO_RAM_SIZE, "PUKCC_MAX_LIMBS doesn't fit the crypto RAM");
+
+size_t pukccMinLimbs = PUKCC_DEFAULT_MIN_LIMBS;
+uint32_t pukccErrors = 0;
+uint32_t pukccHwCalls = 0;
+uint32_t pukccVersion = 0;
+
+static bool hwReady = false;
+
+#if PUKCC_USE_HW
+// parameter block; the ROM only needs it for the length of one call
+static pukclParams params;
+#endif
+
+// multN scratch for the widest multiply at any multNThreshold >= 2:
+// n + 1 words, for the Barrett steps in pukccModMultN
+static uint32_t swScratch[5 * (PUKCC_MAX_LIMBS + 1)];
+
+// pukccModMultN: the product, the Barrett quotient estimate (q1, then
+// q3), the products made from it, and the remainder, which has one
+// more word than m
+static uint32_t modProduct[2 * PUKCC_MAX_LIMBS];
+static uint32_t modQ[PUKCC_MAX_LIMBS + 1];
+static uint32_t modQProduct[2 * (PUKCC_MAX_LIMBS + 1)];
+static uint32_t modRem[PUKCC_MAX_LIMBS + 1];
+
+// Barrett constant mu = floor(2^(64k) / m) for the last modulus, and
+// that modulus with a zero word on top so it is k + 1 words like mu
+static uint32_t muMod[PUKCC_MAX_LIMBS + 1];
+static uint32_t mu[PUKCC_MAX_LIMBS + 1];
+static size_t muLimbs = 0;   // k of muMod; 0 before the first one
+
+// computing mu: the normalized dividend 2^(64k), divisor and quotient
+static uint32_t divU[2 * PUKCC_MAX_LIMBS + 2];
+static uint32_t divV[PUKCC_MAX_LIMBS];
+static uint32_t divQ[PUKCC_MAX_LIMBS + 2];
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+#if PUKCC_USE_HW
+static void clearHeader(uint8_t service)
+{
+    memset(&params, 0, sizeof(params));
+    params.service = service;
+}
+#endif
+
+static void swMult(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    multN(r, a, b, n, swScratch);
+}
+
+// one Fmult call. Returns false if the ROM reported an error.
+static bool hwMult(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+#if PUKCC_USE_HW
+    uint32_t bytes = n * 4;
+    uint32_t xOff = 0;
+    uint32_t yOff = xOff + bytes + PUKCC_PAD_BYTES;
+    uint32_t rOff = yOff + bytes + PUKCC_PAD_BYTES;
+    uint8_t *ram = PUKCC_CRYPTO_RAM;
+
+    memcpy(ram + xOff, a, bytes);
+    memset(ram + xOff + bytes, 0, PUKCC_PAD_BYTES);
+    memcpy(ram + yOff, b, bytes);
+    memset(ram + yOff + bytes, 0, PUKCC_PAD_BYTES);
+    memset(ram + rOff, 0, 2 * bytes + PUKCC_PAD_BYTES);
+
+    clearHeader(PUKCL_SERVICE_FMULT);
+    params.option = PUKCL_FMULT_ONLY;
+    params.p.fmult.xBase = PUKCC_NU1(xOff);
+    params.p.fmult.yBase = PUKCC_NU1(yOff);
+    params.p.fmult.zBase = PUKCC_NU1(rOff);   // not read with FMULT_ONLY
+    params.p.fmult.rBase = PUKCC_NU1(rOff);
+    params.p.fmult.xLength = bytes;
+    params.p.fmult.yLength = bytes;
+    PUKCL_PROCESS(&params);
+
+    if (params.status != PUKCL_OK)
+    {
+        return false;
+    }
+    memcpy(r, ram + rOff, 2 * bytes);
+    return true;
+#else
+    (void)r;
+    (void)a;
+    (void)b;
+    (void)n;
+    return false;
+#endif
+}
+
+// pukccMultN without its size limit, so the n + 1 word Barrett
+// multiplies of an n = PUKCC_MAX_LIMBS modulus can use it too (they
+// fit the crypto RAM and swScratch)
+static pukccPath mult(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    if (hwReady && (n >= pukccMinLimbs))
+    {
+        if (hwMult(r, a, b, n))
+        {
+            pukccHwCalls += 1;
+            return PUKCC_PATH_HW;
+        }
+        pukccErrors += 1;
+    }
+    swMult(r, a, b, n);
+    return PUKCC_PATH_SW;
+}
+
+// q[0..ul-vl] = floor(u[0..ul) / v[0..vl)), v[vl-1] != 0, ul > vl.
+// Knuth's algorithm D: one quotient word per step, from a two word
+// estimate that is at most two too big.
+static void divWords(uint32_t *q, const uint32_t *u, size_t ul,
+        const uint32_t *v, size_t vl)
+{
+    if (vl == 1)
+    {
+        uint64_t rem = 0;
+        for (size_t j = ul; j > 0; --j)
+        {
+            uint64_t num = (rem << 32) | u[j - 1];
+            q[j - 1] = (uint32_t)(num / v[0]);
+            rem = num % v[0];
+        }
+        return;
+    }
+
+    // shift both so v's top bit is set; that keeps the estimate close
+    uint32_t s = (uint32_t)__builtin_clz(v[vl - 1]);
+    for (size_t i = vl - 1; i > 0; --i)
+    {
+        divV[i] = (v[i] << s) | (uint32_t)((uint64_t)v[i - 1] >> (32 - s));
+    }
+    divV[0] = v[0] << s;
+    divU[ul] = (uint32_t)((uint64_t)u[ul - 1] >> (32 - s));
+    for (size_t i = ul - 1; i > 0; --i)
+    {
+        divU[i] = (u[i] << s) | (uint32_t)((uint64_t)u[i - 1] >> (32 - s));
+    }
+    divU[0] = u[0] << s;
+
+    uint32_t vTop = divV[vl - 1];
+    uint32_t vNext = divV[vl - 2];
+    for (size_t j = ul - vl + 1; j > 0; --j)
+    {
+        uint32_t *uj = &divU[j - 1];
+        uint64_t num = ((uint64_t)uj[vl] << 32) | uj[vl - 1];
+        uint64_t qhat = num / vTop;
+        uint64_t rhat = num % vTop;
+        while (((qhat >> 32) != 0)
+                || (qhat * vNext > ((rhat << 32) | uj[vl - 2])))
+        {
+            qhat -= 1;
+            rhat += vTop;
+            if ((rhat >> 32) != 0)
+            {
+                break;
+            }
+        }
+
+        // uj[0..vl] -= qhat * divV
+        uint32_t mulCarry = 0;
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < vl; ++i)
+        {
+            uint64_t p = qhat * divV[i] + mulCarry;
+            mulCarry = (uint32_t)(p >> 32);
+            uint64_t diff = (uint64_t)uj[i] - (uint32_t)p - borrow;
+            uj[i] = (uint32_t)diff;
+            borrow = (uint32_t)(diff >> 63);
+        }
+        uint64_t diff = (uint64_t)uj[vl] - mulCarry - borrow;
+        uj[vl] = (uint32_t)diff;
+        q[j - 1] = (uint32_t)qhat;
+
+        // qhat was still one too big: add v back
+        if ((diff >> 63) != 0)
+        {
+            q[j - 1] -= 1;
+            uint32_t carry = 0;
+            for (size_t i = 0; i < vl; ++i)
+            {
+                uint64_t sum = (uint64_t)uj[i] + divV[i] + carry;
+                uj[i] = (uint32_t)sum;
+                carry = (uint32_t)(sum >> 32);
+            }
+            uj[vl] += carry;
+        }
+    }
+}
+
+// mu and muMod for m[0..k), unless they are already for it
+static void barrettSetup(const uint32_t *m, size_t k)
+{
+    if ((k == muLimbs) && (memcmp(m, muMod, k * 4) == 0))
+    {
+        return;
+    }
+
+    // mu = 2^(64k) / m; the dividend is a 1 above 2k zero words
+    static uint32_t power[2 * PUKCC_MAX_LIMBS + 1];
+    memset(power, 0, 2 * k * 4);
+    power[2 * k] = 1;
+    divWords(divQ, power, 2 * k + 1, m, k);
+
+    // mu only needs k + 2 words when m is exactly 2^(32(k-1)); one
+    // less still leaves q3 within 3 of the quotient, which the final
+    // subtractions absorb
+    if (divQ[k + 1] != 0)
+    {
+        memset(mu, 0xFF, (k + 1) * 4);
+    }
+    else
+    {
+        memcpy(mu, divQ, (k + 1) * 4);
+    }
+    memcpy(muMod, m, k * 4);
+    muMod[k] = 0;
+    muLimbs = k;
+}
+
+// x[0..n] >= m[0..n), where x has one more word than m
+static bool geMod(const uint32_t *x, const uint32_t *m, size_t n)
+{
+    if (x[n] != 0)
+    {
+        return true;
+    }
+    for (size_t i = n; i > 0; --i)
+    {
+        if (x[i - 1] != m[i - 1])
+        {
+            return x[i - 1] > m[i - 1];
+        }
+    }
+    return true;
+}
+
+// x[0..n] -= m[0..n)
+static void subMod(uint32_t *x, const uint32_t *m, size_t n)
+{
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t diff = (uint64_t)x[i] - m[i] - borrow;
+        x[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63);
+    }
+    x[n] -= borrow;
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+bool pukccInit(void)
+{
+#if !PUKCC_USE_HW
+    // the ROM interface is unchecked: don't go near it
+    hwReady = false;
+    pukccVersion = 0;
+    return false;
+#else
+#ifndef PUKCC_HOST_SIM
+    MCLK_REGS->MCLK_AHBMASK |= MCLK_AHBMASK_PUKCC_Msk;
+#endif
+    // the crypto RAM is cleared after reset; PUKCL can't run until it's done
+    while ((PUKCCSR & PUKCC_CSR_CLRRAM_BUSY) != 0)
+    {
+    }
+
+    clearHeader(PUKCL_SERVICE_SELF_TEST);
+    PUKCL_PROCESS(&params);
+    hwReady = (params.status == PUKCL_OK);
+    pukccVersion = params.p.selfTest.version;
+    return hwReady;
+#endif
+}
+
+
+bool pukccAvailable(void)
+{
+    return hwReady;
+}
+
+
+pukccPath pukccMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    if ((n == 0) || (n > PUKCC_MAX_LIMBS))
+    {
+        return PUKCC_PATH_ERROR;
+    }
+    return mult(r, a, b, n);
+}
+
+
+pukccPath pukccModMultN(uint32_t *r, const uint32_t *a, const uint32_t *b,
+        const uint32_t *m, size_t n)
+{
+    bool modIsZero = true;
+    for (size_t i = 0; (i < n) && modIsZero; ++i)
+    {
+        modIsZero = (m[i] == 0);
+    }
+    if ((n == 0) || (n > PUKCC_MAX_LIMBS) || modIsZero)
+    {
+        return PUKCC_PATH_ERROR;
+    }
+
+    // k: m's length without its leading zero words. The product is
+    // under m^2, so it fits 2k words.
+    size_t k = n;
+    while (m[k - 1] == 0)
+    {
+        --k;
+    }
+    pukccPath path = mult(modProduct, a, b, n);
+    barrettSetup(m, k);
+
+    // Barrett: q1 = x / 2^(32(k-1)), q3 = q1 * mu / 2^(32(k+1)) is the
+    // quotient or up to 3 less, and x - q3 * m is worked out mod
+    // 2^(32(k+1)), where it fits
+    for (size_t i = 0; i <= k; ++i)
+    {
+        modQ[i] = (k - 1 + i < 2 * n) ? modProduct[k - 1 + i] : 0;
+    }
+    pukccPath qPath = mult(modQProduct, modQ, mu, k + 1);
+    memcpy(modQ, &modQProduct[k + 1], (k + 1) * 4);
+    pukccPath rPath = mult(modQProduct, modQ, muMod, k + 1);
+
+    uint32_t borrow = 0;
+    for (size_t i = 0; i <= k; ++i)
+    {
+        uint64_t diff = (uint64_t)modProduct[i] - modQProduct[i] - borrow;
+        modRem[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63);
+    }
+    while (geMod(modRem, m, k))
+    {
+        subMod(modRem, m, k);
+    }
+
+    memcpy(r, modRem, k * 4);
+    memset(r + k, 0, (n - k) * 4);
+
+    // the PUKCC only gets the credit if it did every multiply; what's
+    // left in software is linear in n
+    if ((qPath != PUKCC_PATH_HW) || (rPath != PUKCC_PATH_HW))
+    {
+        path = PUKCC_PATH_SW;
+    }
+    return path;
+}
+
+/* *****************************************************************************
+ End of File
+ */
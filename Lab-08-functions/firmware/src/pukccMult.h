@@ -0,0 +1,216 @@
+/* ************************************************************************** */
+/** Wide multiply on the PUKCC crypto coprocessor
+
+  @File Name
+    pukccMult.h
+
+  @Summary
+    Big-integer multiply and modular multiply that run on the PUKCC for
+    wide operands and in software (multN) for narrow ones.
+
+  @Description
+    The DFP only declares PUKCC as "typedef void Pukcc": the controller
+    has no documented registers and is driven through the PUKCL library
+    in ROM. A call fills in a parameter block, puts the operands in the
+    4 KB crypto RAM and jumps to the ROM entry point.
+
+    The ROM entry, crypto RAM address, service codes and parameter block
+    layout below follow the PUKCL headers Microchip ships with the SAM
+    D5x/E5x PUKCC examples (CryptoLib_Headers_pb.h and the files it
+    includes: service codes, PUKCL_OK, the PUKCL_PARAM block, and the
+    vPUKCL_Process entry at 0x02000001). They have not been checked
+    against the PUKCL version in this chip's ROM, and the DFP has no
+    PUKCL definitions to check them with. A wrong entry point or CSR
+    address would HardFault or hang inside pukccInit, where no
+    fallback can catch it, so the ROM path is only built with
+    PUKCC_USE_HW set to 1 (it is 0 by default on the target). Set it
+    once the values have been checked against Microchip's CryptoLib
+    headers on a board.
+    With it on, pukccInit runs the PUKCL self test and keeps the version
+    it reports in pukccVersion; the driver only offloads if the test
+    passes, so a wrong service code or status falls back to software.
+
+    pukccModMultN reduces the product with Barrett's method: two more
+    multiplies of n + 1 words, by mu = 2^(64n) / m and by m, which go
+    to the PUKCC the same way, and a few subtractions. mu takes a long
+    division (Knuth's algorithm D) and is kept for the next call with
+    the same modulus. PUKCL's own reductions (Redmod, and Fmult with a
+    modulus) would need its CondCopy/Redmod setup services, which this
+    driver doesn't model.
+
+    Define PUKCC_HOST_SIM to build for a PC: the crypto RAM, the status
+    register and the ROM entry are then replaced by the model in
+    pukccSim.c, so the dispatch and the data layout can be checked off
+    target.
+ */
+/* ************************************************************************** */
+
+#ifndef _PUKCC_MULT_H    /* Guard against multiple inclusion */
+#define _PUKCC_MULT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: PUKCL ROM interface
+    // *****************************************************************************
+    // *****************************************************************************
+
+// 1: call the PUKCL ROM. Off on the target until the values below have
+// been checked on a board; always on for the host model.
+#ifndef PUKCC_USE_HW
+#ifdef PUKCC_HOST_SIM
+#define PUKCC_USE_HW 1
+#else
+#define PUKCC_USE_HW 0
+#endif
+#endif
+
+#define PUKCL_ROM_ENTRY        0x02000001UL  // vPUKCL_Process, Thumb address
+#define PUKCC_CRYPTO_RAM_ADDR  0x02011000UL
+#define PUKCC_CRYPTO_RAM_SIZE  0x1000UL      // bytes
+#define PUKCC_CSR_ADDR         0x4200302CUL  // PUKCCSR
+#define PUKCC_CSR_CLRRAM_BUSY  0x1UL         // crypto RAM is being cleared
+
+#define PUKCL_SERVICE_SELF_TEST 0x01
+#define PUKCL_SERVICE_FMULT     0x48
+#define PUKCL_FMULT_ONLY        0x00         // R = X * Y, no Z term
+#define PUKCL_OK                0xA000
+
+// operand pointers in the parameter block are the low 16 bits of the
+// crypto RAM address ("nu1" in the PUKCL headers)
+#define PUKCC_NU1(offset) ((uint16_t)((PUKCC_CRYPTO_RAM_ADDR + (offset)) & 0xFFFF))
+#define PUKCC_NU1_OFFSET(nu1) ((uint32_t)(uint16_t)((nu1) - PUKCC_NU1(0)))
+
+// PUKCL wants one spare word after every operand
+#define PUKCC_PAD_BYTES 4
+
+// PUKCL parameter block: common header, then the service's parameters
+typedef struct _pukclParams
+{
+    uint8_t  service;
+    uint8_t  subService;
+    uint16_t option;
+    uint16_t specific;    // carry in/out, zero and violation flags
+    uint16_t status;      // PUKCL_OK or an error code, set by the ROM
+    uint32_t reserved[2];
+    union
+    {
+        struct
+        {
+            uint32_t version;       // PUKCL version
+            uint32_t pukccVersion;  // hardware version
+            uint32_t checkNum[2];
+        } selfTest;
+        struct
+        {
+            uint16_t modBase;       // not used with PUKCL_FMULT_ONLY
+            uint16_t cnsBase;
+            uint16_t modLength;
+            uint16_t xBase;
+            uint16_t yBase;
+            uint16_t zBase;
+            uint16_t rBase;
+            uint16_t xLength;       // bytes, a multiple of 4
+            uint16_t yLength;
+            uint16_t reserved;
+        } fmult;
+    } p;
+} pukclParams;
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Driver
+    // *****************************************************************************
+    // *****************************************************************************
+
+// widest operand, in 32 bit words, either path accepts. X, Y and the
+// 2n word product all fit in the crypto RAM with their padding, even
+// for the n + 1 word multiplies of pukccModMultN.
+#define PUKCC_MAX_LIMBS 128
+
+// default for pukccMinLimbs. Below this the coprocessor setup (copying
+// in and out of the crypto RAM) costs more than the multiply.
+#define PUKCC_DEFAULT_MIN_LIMBS 16
+
+// which path a call took
+typedef enum
+{
+    PUKCC_PATH_SW = 0,   // multN in software
+    PUKCC_PATH_HW,       // PUKCC Fmult
+    PUKCC_PATH_ERROR     // bad arguments, nothing computed
+} pukccPath;
+
+// operands with at least this many words go to the PUKCC
+extern size_t pukccMinLimbs;
+
+// number of PUKCC calls that returned an error status and were redone
+// in software
+extern uint32_t pukccErrors;
+
+// number of multiplies the PUKCC finished: one per pukccMultN call and
+// up to three per pukccModMultN call
+extern uint32_t pukccHwCalls;
+
+// PUKCL version reported by the last pukccInit self test (0 before it)
+extern uint32_t pukccVersion;
+
+// wait for the crypto RAM clear and run the PUKCL self test. Returns
+// true if the PUKCC will be used; false means everything runs in software.
+// With PUKCC_USE_HW 0 it touches nothing and returns false.
+bool pukccInit(void);
+
+// true once pukccInit has passed
+bool pukccAvailable(void);
+
+// r[0..2n) = a[0..n) * b[0..n), little-endian 32 bit words,
+// 1 <= n <= PUKCC_MAX_LIMBS. r must not overlap a or b.
+pukccPath pukccMultN(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+// r[0..n) = a * b mod m. a and b must be less than m and m must not be 0.
+// The product and the two Barrett multiplies each go to the PUKCC or
+// multN like pukccMultN; PUKCC_PATH_HW means all three ran on the PUKCC.
+pukccPath pukccModMultN(uint32_t *r, const uint32_t *a, const uint32_t *b,
+        const uint32_t *m, size_t n);
+
+
+#ifdef PUKCC_HOST_SIM
+    // *****************************************************************************
+    // Section: Host model (pukccSim.c)
+    // *****************************************************************************
+
+extern uint32_t pukccSimCryptoRam[PUKCC_CRYPTO_RAM_SIZE / 4];
+extern volatile uint32_t pukccSimCsr;
+extern uint32_t pukccSimCalls;       // PUKCL calls of any service
+extern bool pukccSimFailSelfTest;    // set to make the self test fail
+extern bool pukccSimFailFmult;       // set to make Fmult return an error
+
+// version the model's self test reports
+#define PUKCC_SIM_VERSION 0x53494D00
+
+// stands in for the ROM entry point
+void pukccSimProcess(pukclParams *params);
+
+// clear the model and all of the flags/counters above
+void pukccSimReset(void);
+#endif
+
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PUKCC_MULT_H */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,88 @@
+/* ************************************************************************** */
+/** Random test vectors
+
+  @File Name
+    randVectors.c
+
+  @Summary
+    TRNG seed plus xorshift32 sequence; see randVectors.h.
+
+  @Description
+    Builds on a PC with TRNG_HOST_SIM defined: the TRNG interrupt is
+    then delivered by trngSimRun() from the model in trngSim.c.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "definitions.h"                // TRNG plib
+#include "randVectors.h"
+#ifdef TRNG_HOST_SIM
+#include "trngSim.h"
+#endif
+
+static volatile bool trngReady = false;
+static volatile uint32_t trngValue = 0;
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Local Functions                                                   */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+static void trngHandler(uint32_t random, uintptr_t context)
+{
+    trngValue = random;
+    trngReady = true;
+}
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+uint32_t randSeedFromTrng(void)
+{
+    trngReady = false;
+    TRNG_CallbackRegister(trngHandler, 0);
+    TRNG_RandomNumberGenerate();
+    while (trngReady == false)
+    {
+#ifdef TRNG_HOST_SIM
+        (void)trngSimRun();
+#endif
+    }
+    return trngValue;
+}
+
+
+void randVectorsInit(randVectors *rv, uint32_t seed)
+{
+    rv->seed = seed;
+    rv->state = (seed != 0) ? seed : RAND_VECTORS_ZERO_SEED;
+    rv->count = 0;
+}
+
+
+void randVectorsFill(randVectors *rv, uint32_t *packed, size_t n)
+{
+    uint32_t x = rv->state;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        packed[i] = x;
+    }
+    rv->state = x;
+    rv->count += n;
+}
+
+/* *****************************************************************************
+ End of File
+ */
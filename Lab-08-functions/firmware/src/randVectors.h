@@ -0,0 +1,62 @@
+/* ************************************************************************** */
+/** Random test vectors
+
+  @File Name
+    randVectors.h
+
+  @Summary
+    Reproducible random packed values for the kernel tests.
+
+  @Description
+    The TRNG only picks the seed. Every value after that comes from a
+    xorshift32 generator, so a run is replayed exactly by starting from
+    the same seed; the seed is printed at the start of every run. The
+    generator is also much faster than the TRNG, which needs 84 APB
+    clocks per word, so a batch can be refilled between kernel calls
+    without slowing them down.
+ */
+/* ************************************************************************** */
+
+#ifndef _RAND_VECTORS_H    /* Guard against multiple inclusion */
+#define _RAND_VECTORS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// generator state. xorshift32 can't start from 0, so a 0 seed is
+// replaced by RAND_VECTORS_ZERO_SEED.
+#define RAND_VECTORS_ZERO_SEED 0x2545F491UL
+
+typedef struct _randVectors
+{
+    uint32_t seed;    // what the run started from, for replay
+    uint32_t state;
+    uint32_t count;   // values made since the seed
+} randVectors;
+
+// one random number from the TRNG, read with its interrupt.
+// Waits about 84 APB clocks.
+uint32_t randSeedFromTrng(void);
+
+// start rv at seed
+void randVectorsInit(randVectors *rv, uint32_t seed);
+
+// next n values of the sequence, into packed[0..n)
+void randVectorsFill(randVectors *rv, uint32_t *packed, size_t n);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RAND_VECTORS_H */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -43,6 +43,49 @@ static char * fail = "FAIL";
 static char * oops = "OOPS!!!";
 
 
+// Q15 edge cases: +/- full scale, +/- 1 LSB, +/- 0.5, 0, and a mix
+const uint32_t q15TestVectors[NUM_Q15_TEST_VECTORS] = {
+    0x00000000,  // 0, 0
+    0x7FFF7FFF,  // max, max
+    0x80008000,  // -1.0, -1.0
+    0x7FFF8000,  // max, -1.0
+    0x00010001,  // +1 LSB, +1 LSB
+    0xFFFFFFFF,  // -1 LSB, -1 LSB
+    0x4000C000,  // 0.5, -0.5
+    0xC0004000,  // -0.5, 0.5
+    0x12345678,
+    0xEDCBA987
+};
+
+const divVector divTestVectors[NUM_DIV_TEST_VECTORS] = {
+    {          0,          1 },
+    {          1,          1 },
+    {          7,          2 },
+    {         -7,          2 },  // C rounds toward 0: -3, rem -1
+    {          7,         -2 },
+    {         -7,         -2 },
+    {        100,          7 },
+    {          5,         10 },  // quotient 0
+    { 0x7FFFFFFF,          1 },
+    { 0x7FFFFFFF,         -1 },
+    { INT32_MIN,           1 },
+    { INT32_MIN,          -1 },  // overflows: INT32_MIN, rem 0
+    { INT32_MIN,   0x7FFFFFFF },
+    { 0x7FFFFFFF,  INT32_MIN },
+    {         42,          0 },  // divide by 0: 0, rem 42
+    {         -1,          0 },
+    {         -1,          3 },  // unsigned: 0xFFFFFFFF / 3
+    { 0x12345678,     0x1234 },
+    { (int32_t)0xEDCBA987, 0x10001 },
+    {       1000,       1000 }
+};
+
+const uint32_t divConstDivisors[NUM_DIV_CONST_DIVISORS] = {
+    1, 2, 3, 5, 7, 10, 60, 641, 1000,
+    0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFE, 0xFFFFFFFF
+};
+
+
 
 /* ************************************************************************** */
 /* ************************************************************************** */
@@ -127,6 +170,24 @@ static char * oops = "OOPS!!!";
         return 3;
     }
  */
+// C version of the SSAT instruction: clamp v to a signed 'bits'-bit value
+static int32_t ssat(int32_t v, int32_t bits, bool *clamped)
+{
+    int32_t max = (int32_t)((1UL << (bits - 1)) - 1);
+    int32_t min = -max - 1;
+    if (v > max)
+    {
+        *clamped = true;
+        return max;
+    }
+    if (v < min)
+    {
+        *clamped = true;
+        return min;
+    }
+    return v;
+}
+
 static void check(int32_t in1, 
         int32_t in2, 
         int32_t *goodCount, 
@@ -207,10 +268,271 @@ int32_t calcExpectedValues(
     e->initProduct = e->absA * e->absB;
     e->finalProduct = e->inputA * e->inputB;
 
+    // saturating version: clamp the operands, then the product
+    bool clamped = false;
+    int32_t satA = ssat(e->inputA, ASM_SAT_OPERAND_BITS, &clamped);
+    int32_t satB = ssat(e->inputB, ASM_SAT_OPERAND_BITS, &clamped);
+    e->satProduct = ssat(satA * satB, ASM_SAT_BITS, &clamped);
+    e->rngError = clamped ? 1 : 0;
+    e->prodIsNeg = (e->satProduct < 0) ? 1 : 0;
+
     return 0;
 }
 
 
+void calcExpectedValuesN(
+            const int32_t *packedVals,
+            uint32_t numVals,
+            expectedValues *e)
+{
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        calcExpectedValues(i, "", packedVals[i], &e[i]);
+    }
+}
+
+
+// saturate to a Q15 halfword
+static uint32_t sat16(int32_t v)
+{
+    bool clamped = false;
+    return (uint16_t)ssat(v, 16, &clamped);
+}
+
+// saturating 32 bit add, like QADD
+static int32_t qadd(int32_t a, int32_t b)
+{
+    int64_t sum = (int64_t)a + b;
+    if (sum > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (sum < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)sum;
+}
+
+#define Q15_HI(x) ((int32_t)(int16_t)((x) >> 16))
+#define Q15_LO(x) ((int32_t)(int16_t)(x))
+#define Q15_PACK(hi, lo) (((hi) << 16) | (lo))
+
+static uint32_t q15MulHalf(int32_t a, int32_t b)
+{
+    return sat16((a * b + 0x4000) >> 15);   // round to nearest
+}
+
+uint32_t q15MulRef(uint32_t x, uint32_t y)
+{
+    return Q15_PACK(q15MulHalf(Q15_HI(x), Q15_HI(y)),
+            q15MulHalf(Q15_LO(x), Q15_LO(y)));
+}
+
+int32_t q15MacRef(int32_t acc, uint32_t x, uint32_t y)
+{
+    acc = qadd(acc, Q15_HI(x) * Q15_HI(y));
+    return qadd(acc, Q15_LO(x) * Q15_LO(y));
+}
+
+uint32_t q15AddRef(uint32_t x, uint32_t y)
+{
+    return Q15_PACK(sat16(Q15_HI(x) + Q15_HI(y)), sat16(Q15_LO(x) + Q15_LO(y)));
+}
+
+uint32_t q15SubRef(uint32_t x, uint32_t y)
+{
+    return Q15_PACK(sat16(Q15_HI(x) - Q15_HI(y)), sat16(Q15_LO(x) - Q15_LO(y)));
+}
+
+uint32_t q15ScaleRef(uint32_t x, int32_t gain)
+{
+    // (gain * x) >> 15 rounds down, same as SMULWx
+    return Q15_PACK(sat16((int32_t)(((int64_t)gain * Q15_HI(x)) >> 15)),
+            sat16((int32_t)(((int64_t)gain * Q15_LO(x)) >> 15)));
+}
+
+uint32_t q15CmulRef(uint32_t x, uint32_t y, bool conj)
+{
+    int32_t xr = Q15_LO(x);
+    int32_t xi = Q15_HI(x);
+    int32_t yr = Q15_LO(y);
+    int32_t yi = Q15_HI(y);
+    if (conj == true)
+    {
+        yi = -yi;
+    }
+    // in 64 bits, so -1-1j * -1-1j (+2.0) saturates to 0x7FFF
+    int64_t re = (int64_t)xr * yr - (int64_t)xi * yi;
+    int64_t im = (int64_t)xr * yi + (int64_t)xi * yr;
+    return Q15_PACK(sat16((int32_t)(im >> 15)), sat16((int32_t)(re >> 15)));
+}
+
+
+int64_t calcExpectedDot16(
+        int64_t acc,
+        const uint32_t *x,
+        const uint32_t *y,
+        uint32_t numVals)
+{
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        acc += (int64_t)((int16_t)(x[i] >> 16)) * (int16_t)(y[i] >> 16);
+        acc += (int64_t)((int16_t)x[i]) * (int16_t)y[i];
+    }
+    return acc;
+}
+
+
+void calcExpectedDiv(int32_t n, int32_t d, divResults *e)
+{
+    if (d == 0)
+    {
+        e->quot = 0;
+        e->rem = n;
+    }
+    else if ((n == INT32_MIN) && (d == -1))
+    {
+        e->quot = INT32_MIN;
+        e->rem = 0;
+    }
+    else
+    {
+        e->quot = n / d;
+        e->rem = n % d;
+    }
+    e->dmQuot = e->quot;
+    e->dmRem = e->rem;
+
+    uint32_t un = (uint32_t)n;
+    uint32_t ud = (uint32_t)d;
+    e->uQuot = (ud == 0) ? 0 : un / ud;
+    e->uRem = (ud == 0) ? un : un % ud;
+    e->udmQuot = e->uQuot;
+    e->udmRem = e->uRem;
+}
+
+
+void calcExpectedFir(
+        const int16_t *h,
+        uint32_t numTaps,
+        const int16_t *in,
+        int16_t *out,
+        uint32_t numVals)
+{
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        // SMLAD wraps at 32 bits; truncating the 64 bit sum does the same
+        int64_t acc = 0;
+        for (uint32_t k = 0; (k < numTaps) && (k <= i); ++k)
+        {
+            acc += (int32_t)h[k] * in[i - k];
+        }
+        bool clamped = false;
+        out[i] = (int16_t)ssat((int32_t)(uint32_t)acc >> 15, 16, &clamped);
+    }
+}
+
+
+void calcExpectedMultN(
+        uint32_t *r,
+        const uint32_t *a,
+        const uint32_t *b,
+        uint32_t numLimbs)
+{
+    for (uint32_t i = 0; i < 2 * numLimbs; ++i)
+    {
+        r[i] = 0;
+    }
+    for (uint32_t i = 0; i < numLimbs; ++i)
+    {
+        uint64_t carry = 0;
+        for (uint32_t j = 0; j < numLimbs; ++j)
+        {
+            carry += (uint64_t)a[j] * b[i] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        r[i + numLimbs] = (uint32_t)carry;
+    }
+}
+
+
+// x[0..n] = x + y mod m, with x, y < m. x has one spare top word.
+static void addMod(uint32_t *x, const uint32_t *y, const uint32_t *m,
+        uint32_t numLimbs)
+{
+    uint64_t carry = 0;
+    for (uint32_t i = 0; i < numLimbs; ++i)
+    {
+        carry += (uint64_t)x[i] + y[i];
+        x[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    x[numLimbs] = (uint32_t)carry;
+
+    // subtract m if x >= m
+    bool ge = (x[numLimbs] != 0);
+    if (!ge)
+    {
+        ge = true;
+        for (uint32_t i = numLimbs; i > 0; --i)
+        {
+            if (x[i - 1] != m[i - 1])
+            {
+                ge = (x[i - 1] > m[i - 1]);
+                break;
+            }
+        }
+    }
+    if (ge)
+    {
+        int64_t borrow = 0;
+        for (uint32_t i = 0; i < numLimbs; ++i)
+        {
+            borrow += (int64_t)x[i] - m[i];
+            x[i] = (uint32_t)borrow;
+            borrow >>= 32;
+        }
+    }
+    x[numLimbs] = 0;
+}
+
+
+void calcExpectedModMultN(
+        uint32_t *r,
+        const uint32_t *a,
+        const uint32_t *b,
+        const uint32_t *m,
+        uint32_t numLimbs)
+{
+    static uint32_t acc[MULTN_MAX_TEST_LIMBS + 1];
+    static uint32_t dbl[MULTN_MAX_TEST_LIMBS];
+
+    for (uint32_t i = 0; i <= numLimbs; ++i)
+    {
+        acc[i] = 0;
+    }
+    for (uint32_t bit = 32 * numLimbs; bit > 0; --bit)
+    {
+        // acc = 2 * acc mod m, then + a if this bit of b is set
+        for (uint32_t i = 0; i < numLimbs; ++i)
+        {
+            dbl[i] = acc[i];
+        }
+        addMod(acc, dbl, m, numLimbs);
+        if ((b[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1)
+        {
+            addMod(acc, a, m, numLimbs);
+        }
+    }
+    for (uint32_t i = 0; i < numLimbs; ++i)
+    {
+        r[i] = acc[i];
+    }
+}
+
+
 /** 
   @Function
     int ExampleInterfaceFunctionName ( int param1, int param2 ) 
@@ -247,12 +569,12 @@ void testAsmUnpack(
     {
     // build the string to be sent out over the serial lines
     snprintf((char*)txBuffer, MAX_PRINT_LEN,
-            "========= testAsmUnpack %s test number: %ld\r\n"
-            "packed (input) value:    0x%08lx\r\n"
-            "unpacked A (multiplicand) value: %11ld; 0x%08lx\r\n"
-            "expected A (multiplicand) value: %11ld; 0x%08lx\r\n"
-            "unpacked B (multiplier) value:   %11ld; 0x%08lx\r\n"
-            "expected B (multiplier) value:   %11ld; 0x%08lx\r\n"
+            "========= testAsmUnpack %s test number: %" PRId32 "\r\n"
+            "packed (input) value:    0x%08" PRIx32 "\r\n"
+            "unpacked A (multiplicand) value: %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "expected A (multiplicand) value: %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "unpacked B (multiplier) value:   %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "expected B (multiplier) value:   %11" PRId32 "; 0x%08" PRIx32 "\r\n"
             "unpacked A pass/fail:            %s\r\n"
             "unpacked B pass/fail:            %s\r\n"
             "========= END -- testAsmUnpack() debug output\r\n"
@@ -301,13 +623,13 @@ void testAsmAbs(
     {
     // build the string to be sent out over the serial lines
     snprintf((char*)txBuffer, MAX_PRINT_LEN,
-            "========= testAsmAbs %s test number: %ld\r\n"
-            "signed input value:    0x%08lx\r\n"
-            "abs value stored in mem:  %11ld; 0x%08lx; %s\r\n"
-            "abs value returned in r0: %11ld; 0x%08lx; %s\r\n"
-            "sign bit stored in mem:   %11ld; 0x%08lx; %s\r\n"
-            "expected abs value:   %11ld; 0x%08lx\r\n"
-            "expected sign bit:    %11ld\r\n"
+            "========= testAsmAbs %s test number: %" PRId32 "\r\n"
+            "signed input value:    0x%08" PRIx32 "\r\n"
+            "abs value stored in mem:  %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+            "abs value returned in r0: %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+            "sign bit stored in mem:   %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+            "expected abs value:   %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "expected sign bit:    %11" PRId32 "\r\n"
             "========= END -- testAsmAbs() debug output\r\n"
             "\r\n",
             desc,
@@ -349,13 +671,13 @@ void testAsmMult(
     {
     // build the string to be sent out over the serial lines
     snprintf((char*)txBuffer, MAX_PRINT_LEN,
-            "========= testAsmMult %s test number: %ld\r\n"
+            "========= testAsmMult %s test number: %" PRId32 "\r\n"
             "Inputs:\r\n"
-            "abs value A:             %11ld; 0x%08lx\r\n"
-            "abs value B:             %11ld; 0x%08lx\r\n"
+            "abs value A:             %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "abs value B:             %11" PRId32 "; 0x%08" PRIx32 "\r\n"
             "Output:\r\n"
-            "product abs(A) * abs(B): %11ld; 0x%08lx; %s\r\n"
-            "Expected product:        %11ld; 0x%08lx\r\n"
+            "product abs(A) * abs(B): %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+            "Expected product:        %11" PRId32 "; 0x%08" PRIx32 "\r\n"
             "========= END -- testAsmMult() debug output\r\n"
             "\r\n",
             desc,
@@ -395,14 +717,14 @@ void testAsmFixSign(
     {
     // build the string to be sent out over the serial lines
     snprintf((char*)txBuffer, MAX_PRINT_LEN,
-            "========= testAsmFixSign %s test number: %ld\r\n"
+            "========= testAsmFixSign %s test number: %" PRId32 "\r\n"
             "Inputs:\r\n"
-            "Initial (unsigned) product: %11ld; 0x%08lx\r\n"
-            "sign bit A:                 %ld\r\n"
-            "sign bit B:                 %ld\r\n"
+            "Initial (unsigned) product: %11" PRIu32 "; 0x%08" PRIx32 "\r\n"
+            "sign bit A:                 %" PRId32 "\r\n"
+            "sign bit B:                 %" PRId32 "\r\n"
             "Output:\r\n"
-            "Final (signed) product:     %11ld; 0x%08lx; %s\r\n"
-            "Expected product:           %11ld; 0x%08lx\r\n"
+            "Final (signed) product:     %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+            "Expected product:           %11" PRId32 "; 0x%08" PRIx32 "\r\n"
             "========= END -- testAsmFixSign() debug output\r\n"
             "\r\n",
             desc,
@@ -466,10 +788,10 @@ void testAsmMain(
     if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
     {
     snprintf((char*)txBuffer, MAX_PRINT_LEN,
-            "========= testAsmMain %s test number: %ld\r\n"
-            "test case INPUT: packed value:    0x%08lx\r\n"
-            "test case INPUT: multiplier (a):   %11ld; 0x%08lx\r\n"
-            "test case INPUT: multiplicand (b): %11ld; 0x%08lx\r\n"
+            "========= testAsmMain %s test number: %" PRId32 "\r\n"
+            "test case INPUT: packed value:    0x%08" PRIx32 "\r\n"
+            "test case INPUT: multiplier (a):   %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "test case INPUT: multiplicand (b): %11" PRId32 "; 0x%08" PRIx32 "\r\n"
             "a check p/f:           %s\r\n"
             "b check p/f:           %s\r\n"
             "sign bit a check p/f:  %s\r\n"
@@ -480,15 +802,15 @@ void testAsmMain(
             "final product p/f:     %s\r\n"
             "returned result p/f:   %s\r\n"
             "debug values        expected        actual\r\n"
-            "a_Multiplicand:..%11ld   %11ld\r\n"
-            "b_Multiplier:....%11ld   %11ld\r\n"
-            "a_Sign:..........%11ld   %11ld\r\n"
-            "b_Sign:..........%11ld   %11ld\r\n"
-            "a_Abs:...........%11ld   %11ld\r\n"
-            "b_Abs:...........%11ld   %11ld\r\n"
-            "init_Product:....%11ld   %11ld\r\n"
-            "final_Product:...%11ld   %11ld\r\n"
-            "returned value:..%11ld   %11ld\r\n",
+            "a_Multiplicand:..%11" PRId32 "   %11" PRId32 "\r\n"
+            "b_Multiplier:....%11" PRId32 "   %11" PRId32 "\r\n"
+            "a_Sign:..........%11" PRId32 "   %11" PRId32 "\r\n"
+            "b_Sign:..........%11" PRId32 "   %11" PRId32 "\r\n"
+            "a_Abs:...........%11" PRId32 "   %11" PRId32 "\r\n"
+            "b_Abs:...........%11" PRId32 "   %11" PRId32 "\r\n"
+            "init_Product:....%11" PRId32 "   %11" PRId32 "\r\n"
+            "final_Product:...%11" PRId32 "   %11" PRId32 "\r\n"
+            "returned value:..%11" PRId32 "   %11" PRId32 "\r\n",
             desc,
             testNum,
             exp->packedVal,
@@ -519,6 +841,743 @@ void testAsmMain(
     return;
 }
 
+
+
+void testAsmMainBatch(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * packedVals, // inputs
+        const int32_t * products, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    expectedValues exp;
+
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        char *prodCheck = oops;
+        int32_t prevFails = *failCount;
+
+        calcExpectedValues(i, desc, packedVals[i], &exp);
+        check(exp.finalProduct, products[i], passCount, failCount, &prodCheck);
+
+        if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != prevFails)))
+        {
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "========= testAsmMainBatch %s test number: %" PRId32 ", element: %" PRIu32 "\r\n"
+                "packed (input) value:    0x%08" PRIx32 "\r\n"
+                "product stored in mem:   %11" PRId32 "; 0x%08" PRIx32 "; %s\r\n"
+                "Expected product:        %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+                "========= END -- testAsmMainBatch() debug output\r\n"
+                "\r\n",
+                desc,
+                testNum,
+                i,
+                packedVals[i],
+                products[i],products[i],prodCheck,
+                exp.finalProduct,exp.finalProduct
+                );
+
+        printAndWait((char *)txBuffer, txComplete);
+        }
+    }
+    return;
+}
+
+
+
+void testAsmDot16(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t numVals, // inputs
+        int64_t r0r1_result, // outputs
+        int64_t expectedResult, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    char *hiCheck = oops;
+    char *loCheck = oops;
+
+    // check() compares 32 bit values, so do each half of the result
+    check((int32_t)(expectedResult >> 32), (int32_t)(r0r1_result >> 32),
+            passCount, failCount, &hiCheck);
+    check((int32_t)expectedResult, (int32_t)r0r1_result,
+            passCount, failCount, &loCheck);
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmDot16 %s test number: %" PRId32 "\r\n"
+            "number of packed values: %" PRIu32 "\r\n"
+            "result high word (r1):   0x%08" PRIx32 "; %s\r\n"
+            "result low word (r0):    0x%08" PRIx32 "; %s\r\n"
+            "expected high word:      0x%08" PRIx32 "\r\n"
+            "expected low word:       0x%08" PRIx32 "\r\n"
+            "========= END -- testAsmDot16() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            numVals,
+            (uint32_t)(r0r1_result >> 32), hiCheck,
+            (uint32_t)r0r1_result, loCheck,
+            (uint32_t)(expectedResult >> 32),
+            (uint32_t)expectedResult
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+
+void testAsmAbsPacked(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t packedVal, // inputs
+        uint32_t absPacked, // vals stored in mem
+        uint32_t signBits,
+        uint32_t r0_absPacked, // outputs
+        expectedValues * exp, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    char *absACheck = oops;
+    char *absBCheck = oops;
+    char *r0Check = oops;
+    char *signACheck = oops;
+    char *signBCheck = oops;
+
+    check(exp->absA, absPacked >> 16, passCount, failCount, &absACheck);
+    check(exp->absB, absPacked & 0xFFFF, passCount, failCount, &absBCheck);
+    check(absPacked, r0_absPacked, passCount, failCount, &r0Check);
+    check(exp->signA, (signBits >> 1) & 1, passCount, failCount, &signACheck);
+    check(exp->signB, signBits & 1, passCount, failCount, &signBCheck);
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmAbsPacked %s test number: %" PRId32 "\r\n"
+            "packed (input) value:     0x%08" PRIx32 "\r\n"
+            "abs values stored in mem: 0x%08" PRIx32 "; a: %s; b: %s\r\n"
+            "abs values returned in r0: 0x%08" PRIx32 "; %s\r\n"
+            "sign bits stored in mem:  0x%08" PRIx32 "; a: %s; b: %s\r\n"
+            "expected abs a, abs b:    %" PRId32 ", %" PRId32 "\r\n"
+            "expected sign a, sign b:  %" PRId32 ", %" PRId32 "\r\n"
+            "========= END -- testAsmAbsPacked() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            packedVal,
+            absPacked, absACheck, absBCheck,
+            r0_absPacked, r0Check,
+            signBits, signACheck, signBCheck,
+            exp->absA, exp->absB,
+            exp->signA, exp->signB
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+
+void testAsmMainSat(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t packedVal, // inputs
+        int32_t r0_satProd, // outputs
+        int32_t rngError, // vals stored in mem
+        int32_t prodIsNeg,
+        int32_t finalProduct,
+        expectedValues * exp, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    char *r0Check = oops;
+    char *finalCheck = oops;
+    char *rngCheck = oops;
+    char *negCheck = oops;
+
+    check(exp->satProduct, r0_satProd, passCount, failCount, &r0Check);
+    check(exp->satProduct, finalProduct, passCount, failCount, &finalCheck);
+    check(exp->rngError, rngError, passCount, failCount, &rngCheck);
+    check(exp->prodIsNeg, prodIsNeg, passCount, failCount, &negCheck);
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmMainSat %s test number: %" PRId32 "\r\n"
+            "packed (input) value:    0x%08" PRIx32 "\r\n"
+            "saturation limits: operands %d bits, product %d bits\r\n"
+            "debug values        expected        actual\r\n"
+            "returned value:..%11" PRId32 "   %11" PRId32 "; %s\r\n"
+            "final_Product:...%11" PRId32 "   %11" PRId32 "; %s\r\n"
+            "rng_Error:.......%11" PRId32 "   %11" PRId32 "; %s\r\n"
+            "prod_Is_Neg:.....%11" PRId32 "   %11" PRId32 "; %s\r\n"
+            "========= END -- testAsmMainSat() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            packedVal,
+            ASM_SAT_OPERAND_BITS, ASM_SAT_BITS,
+            exp->satProduct, r0_satProd, r0Check,
+            exp->satProduct, finalProduct, finalCheck,
+            exp->rngError, rngError, rngCheck,
+            exp->prodIsNeg, prodIsNeg, negCheck
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+
+void testAsmQ15(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t x, // inputs
+        uint32_t y,
+        int32_t acc,
+        int32_t gain,
+        q15Results * r0_results, // outputs
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    char *mulCheck = oops;
+    char *macCheck = oops;
+    char *addCheck = oops;
+    char *subCheck = oops;
+    char *scaleCheck = oops;
+
+    q15Results exp;
+    exp.mul = q15MulRef(x, y);
+    exp.mac = q15MacRef(acc, x, y);
+    exp.add = q15AddRef(x, y);
+    exp.sub = q15SubRef(x, y);
+    exp.scale = q15ScaleRef(x, gain);
+
+    check(exp.mul, r0_results->mul, passCount, failCount, &mulCheck);
+    check(exp.mac, r0_results->mac, passCount, failCount, &macCheck);
+    check(exp.add, r0_results->add, passCount, failCount, &addCheck);
+    check(exp.sub, r0_results->sub, passCount, failCount, &subCheck);
+    check(exp.scale, r0_results->scale, passCount, failCount, &scaleCheck);
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmQ15 %s test number: %" PRId32 "\r\n"
+            "x: 0x%08" PRIx32 "  y: 0x%08" PRIx32 "  acc: 0x%08" PRIx32 "  gain: 0x%04" PRIx32 "\r\n"
+            "function          expected      actual\r\n"
+            "asmQ15Mul:      0x%08" PRIx32 "  0x%08" PRIx32 "; %s\r\n"
+            "asmQ15Mac:      0x%08" PRIx32 "  0x%08" PRIx32 "; %s\r\n"
+            "asmQ15Add:      0x%08" PRIx32 "  0x%08" PRIx32 "; %s\r\n"
+            "asmQ15Sub:      0x%08" PRIx32 "  0x%08" PRIx32 "; %s\r\n"
+            "asmQ15Scale:    0x%08" PRIx32 "  0x%08" PRIx32 "; %s\r\n"
+            "========= END -- testAsmQ15() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            x, y, acc, gain & 0xFFFF,
+            exp.mul, r0_results->mul, mulCheck,
+            exp.mac, r0_results->mac, macCheck,
+            exp.add, r0_results->add, addCheck,
+            exp.sub, r0_results->sub, subCheck,
+            exp.scale, r0_results->scale, scaleCheck
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+
+void testAsmCmul(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * x, // inputs
+        const uint32_t * y,
+        const uint32_t * products, // outputs
+        uint32_t numVals,
+        bool conj, // true: products are x * conj(y)
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        char *prodCheck = oops;
+        int32_t prevFails = *failCount;
+        uint32_t expected = q15CmulRef(x[i], y[i], conj);
+
+        check(expected, products[i], passCount, failCount, &prodCheck);
+
+        if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != prevFails)))
+        {
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "========= testAsmCmul %s test number: %" PRId32 ", element: %" PRIu32 "\r\n"
+                "x (im,re):               0x%08" PRIx32 "\r\n"
+                "y (im,re):               0x%08" PRIx32 "\r\n"
+                "%s stored in mem: 0x%08" PRIx32 "; %s\r\n"
+                "Expected:                0x%08" PRIx32 "\r\n"
+                "========= END -- testAsmCmul() debug output\r\n"
+                "\r\n",
+                desc,
+                testNum,
+                i,
+                x[i],
+                y[i],
+                conj ? "x * conj(y)" : "x * y      ",
+                products[i], prodCheck,
+                expected
+                );
+
+        printAndWait((char *)txBuffer, txComplete);
+        }
+    }
+    return;
+}
+
+
+void testAsmMultN(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * a, // inputs
+        const uint32_t * b,
+        const uint32_t * product, // outputs
+        uint32_t numLimbs,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    static uint32_t expected[2 * MULTN_MAX_TEST_LIMBS];
+    *failCount = 0;
+    *passCount = 0;
+
+    // nothing to check, and no last word to show
+    if (numLimbs == 0)
+    {
+        return;
+    }
+
+    if (numLimbs > MULTN_MAX_TEST_LIMBS)
+    {
+        *failCount = 1;
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "testAsmMultN: %" PRIu32 " limbs is more than MULTN_MAX_TEST_LIMBS\r\n",
+                numLimbs);
+        printAndWait((char *)txBuffer, txComplete);
+        return;
+    }
+
+    calcExpectedMultN(expected, a, b, numLimbs);
+
+    // one check per word; report the first word that is wrong
+    uint32_t firstBad = 2 * numLimbs;
+    char *firstCheck = pass;
+    for (uint32_t i = 0; i < 2 * numLimbs; ++i)
+    {
+        char *wordCheck = oops;
+        check(expected[i], product[i], passCount, failCount, &wordCheck);
+        if ((wordCheck != pass) && (firstBad == 2 * numLimbs))
+        {
+            firstBad = i;
+            firstCheck = wordCheck;
+        }
+    }
+    uint32_t shown = (firstBad < 2 * numLimbs) ? firstBad : 2 * numLimbs - 1;
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmMultN %s test number: %" PRId32 "\r\n"
+            "operand size:            %" PRIu32 " words\r\n"
+            "a[0], a[n-1]:            0x%08" PRIx32 ", 0x%08" PRIx32 "\r\n"
+            "b[0], b[n-1]:            0x%08" PRIx32 ", 0x%08" PRIx32 "\r\n"
+            "wrong words:             %" PRId32 " of %" PRIu32 "\r\n"
+            "r[%" PRIu32 "] stored in mem:     0x%08" PRIx32 "; %s\r\n"
+            "Expected:                0x%08" PRIx32 "\r\n"
+            "========= END -- testAsmMultN() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            numLimbs,
+            a[0], a[numLimbs - 1],
+            b[0], b[numLimbs - 1],
+            *failCount, 2 * numLimbs,
+            shown, product[shown], firstCheck,
+            expected[shown]
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+void testAsmDiv(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        int32_t n, // inputs
+        int32_t d,
+        divResults * r0_results, // outputs
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+    divResults exp;
+    char *quotCheck = oops;
+    char *remCheck = oops;
+    char *dmQuotCheck = oops;
+    char *dmRemCheck = oops;
+    char *uQuotCheck = oops;
+    char *uRemCheck = oops;
+    char *udmQuotCheck = oops;
+    char *udmRemCheck = oops;
+
+    calcExpectedDiv(n, d, &exp);
+    check(exp.quot, r0_results->quot, passCount, failCount, &quotCheck);
+    check(exp.rem, r0_results->rem, passCount, failCount, &remCheck);
+    check(exp.dmQuot, r0_results->dmQuot, passCount, failCount, &dmQuotCheck);
+    check(exp.dmRem, r0_results->dmRem, passCount, failCount, &dmRemCheck);
+    check(exp.uQuot, r0_results->uQuot, passCount, failCount, &uQuotCheck);
+    check(exp.uRem, r0_results->uRem, passCount, failCount, &uRemCheck);
+    check(exp.udmQuot, r0_results->udmQuot, passCount, failCount, &udmQuotCheck);
+    check(exp.udmRem, r0_results->udmRem, passCount, failCount, &udmRemCheck);
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testAsmDiv %s test number: %" PRId32 "\r\n"
+            "n:                       %" PRId32 " (0x%08" PRIx32 ")\r\n"
+            "d:                       %" PRId32 " (0x%08" PRIx32 ")\r\n"
+            "asmDiv returned:         %" PRId32 "; %s\r\n"
+            "asmMod returned:         %" PRId32 "; %s\r\n"
+            "asmDivMod returned:      %" PRId32 "; %s\r\n"
+            "asmDivMod rem in mem:    %" PRId32 "; %s\r\n"
+            "expected quot, rem:      %" PRId32 ", %" PRId32 "\r\n"
+            "asmUDiv returned:        0x%08" PRIx32 "; %s\r\n"
+            "asmUMod returned:        0x%08" PRIx32 "; %s\r\n"
+            "asmUDivMod returned:     0x%08" PRIx32 "; %s\r\n"
+            "asmUDivMod rem in mem:   0x%08" PRIx32 "; %s\r\n"
+            "expected uquot, urem:    0x%08" PRIx32 ", 0x%08" PRIx32 "\r\n"
+            "========= END -- testAsmDiv() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            n, n,
+            d, d,
+            r0_results->quot, quotCheck,
+            r0_results->rem, remCheck,
+            r0_results->dmQuot, dmQuotCheck,
+            r0_results->dmRem, dmRemCheck,
+            exp.quot, exp.rem,
+            r0_results->uQuot, uQuotCheck,
+            r0_results->uRem, uRemCheck,
+            r0_results->udmQuot, udmQuotCheck,
+            r0_results->udmRem, udmRemCheck,
+            exp.uQuot, exp.uRem
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+void testAsmMultQsq(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        int32_t a, // inputs
+        const int32_t * b,
+        const int32_t * products, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        char *prodCheck = oops;
+        int32_t prevFails = *failCount;
+        int32_t expected = a * b[i];
+
+        check(expected, products[i], passCount, failCount, &prodCheck);
+
+        if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != prevFails)))
+        {
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "========= testAsmMultQsq %s test number: %" PRId32 ", element: %" PRIu32 "\r\n"
+                "a:                       %" PRId32 "\r\n"
+                "b:                       %" PRId32 "\r\n"
+                "product returned:        %" PRId32 "; %s\r\n"
+                "Expected:                %" PRId32 "\r\n"
+                "========= END -- testAsmMultQsq() debug output\r\n"
+                "\r\n",
+                desc,
+                testNum,
+                i,
+                a,
+                b[i],
+                products[i], prodCheck,
+                expected
+                );
+
+        printAndWait((char *)txBuffer, txComplete);
+        }
+    }
+    return;
+}
+
+
+void testFirFilter(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const int16_t * h, // inputs
+        uint32_t numTaps,
+        uint32_t blockSize,
+        const int16_t * in,
+        const int16_t * out, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    static int16_t expected[FIR_MAX_TEST_VALS];
+    *failCount = 0;
+    *passCount = 0;
+
+    // nothing to check, and no last sample to show
+    if (numVals == 0)
+    {
+        return;
+    }
+
+    if (numVals > FIR_MAX_TEST_VALS)
+    {
+        *failCount = 1;
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "testFirFilter: %" PRIu32 " samples is more than FIR_MAX_TEST_VALS\r\n",
+                numVals);
+        printAndWait((char *)txBuffer, txComplete);
+        return;
+    }
+
+    calcExpectedFir(h, numTaps, in, expected, numVals);
+
+    // one check per sample; report the first one that is wrong
+    uint32_t firstBad = numVals;
+    char *firstCheck = pass;
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        char *sampleCheck = oops;
+        check(expected[i], out[i], passCount, failCount, &sampleCheck);
+        if ((sampleCheck != pass) && (firstBad == numVals))
+        {
+            firstBad = i;
+            firstCheck = sampleCheck;
+        }
+    }
+    uint32_t shown = (firstBad < numVals) ? firstBad : numVals - 1;
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testFirFilter %s test number: %" PRId32 "\r\n"
+            "taps, block size:        %" PRIu32 ", %" PRIu32 "\r\n"
+            "wrong samples:           %" PRId32 " of %" PRIu32 "\r\n"
+            "in[%" PRIu32 "]:                 %d\r\n"
+            "out[%" PRIu32 "]:                %d; %s\r\n"
+            "Expected:                %d\r\n"
+            "========= END -- testFirFilter() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            numTaps, blockSize,
+            *failCount, numVals,
+            shown, in[shown],
+            shown, out[shown], firstCheck,
+            expected[shown]
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
+
+void testAsmUDivConst(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t d, // inputs
+        const uint32_t * dividends,
+        const uint32_t * quotients, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    *failCount = 0;
+    *passCount = 0;
+
+    for (uint32_t i = 0; i < numVals; ++i)
+    {
+        char *quotCheck = oops;
+        int32_t prevFails = *failCount;
+        uint32_t expected = dividends[i] / d;
+
+        check(expected, quotients[i], passCount, failCount, &quotCheck);
+
+        if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != prevFails)))
+        {
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "========= testAsmUDivConst %s test number: %" PRId32 ", element: %" PRIu32 "\r\n"
+                "n:                       0x%08" PRIx32 "\r\n"
+                "d:                       0x%08" PRIx32 "\r\n"
+                "quotient stored in mem:  0x%08" PRIx32 "; %s\r\n"
+                "Expected:                0x%08" PRIx32 "\r\n"
+                "========= END -- testAsmUDivConst() debug output\r\n"
+                "\r\n",
+                desc,
+                testNum,
+                i,
+                dividends[i],
+                d,
+                quotients[i], quotCheck,
+                expected
+                );
+
+        printAndWait((char *)txBuffer, txComplete);
+        }
+    }
+    return;
+}
+
+
+void testPukccModMult(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * a, // inputs
+        const uint32_t * b,
+        const uint32_t * m,
+        const uint32_t * result, // outputs
+        uint32_t numLimbs,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        )
+{
+    static uint32_t expected[MULTN_MAX_TEST_LIMBS];
+    *failCount = 0;
+    *passCount = 0;
+
+    // nothing to check, and no last word to show
+    if (numLimbs == 0)
+    {
+        return;
+    }
+
+    if (numLimbs > MULTN_MAX_TEST_LIMBS)
+    {
+        *failCount = 1;
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "testPukccModMult: %" PRIu32 " limbs is more than MULTN_MAX_TEST_LIMBS\r\n",
+                numLimbs);
+        printAndWait((char *)txBuffer, txComplete);
+        return;
+    }
+
+    calcExpectedModMultN(expected, a, b, m, numLimbs);
+
+    uint32_t firstBad = numLimbs;
+    char *firstCheck = pass;
+    for (uint32_t i = 0; i < numLimbs; ++i)
+    {
+        char *wordCheck = oops;
+        check(expected[i], result[i], passCount, failCount, &wordCheck);
+        if ((wordCheck != pass) && (firstBad == numLimbs))
+        {
+            firstBad = i;
+            firstCheck = wordCheck;
+        }
+    }
+    uint32_t shown = (firstBad < numLimbs) ? firstBad : numLimbs - 1;
+
+    if( (onlyPrintFails == false) || ((onlyPrintFails == true) && (*failCount != 0)))
+    {
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= testPukccModMult %s test number: %" PRId32 "\r\n"
+            "operand size:            %" PRIu32 " words\r\n"
+            "a[n-1], b[n-1], m[n-1]:  0x%08" PRIx32 ", 0x%08" PRIx32 ", 0x%08" PRIx32 "\r\n"
+            "wrong words:             %" PRId32 " of %" PRIu32 "\r\n"
+            "r[%" PRIu32 "] stored in mem:     0x%08" PRIx32 "; %s\r\n"
+            "Expected:                0x%08" PRIx32 "\r\n"
+            "========= END -- testPukccModMult() debug output\r\n"
+            "\r\n",
+            desc,
+            testNum,
+            numLimbs,
+            a[numLimbs - 1], b[numLimbs - 1], m[numLimbs - 1],
+            *failCount, numLimbs,
+            shown, result[shown], firstCheck,
+            expected[shown]
+            );
+
+    printAndWait((char *)txBuffer, txComplete);
+    }
+    return;
+}
+
 /* *****************************************************************************
  End of File
  */
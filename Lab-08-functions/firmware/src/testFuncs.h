@@ -67,6 +67,21 @@ extern "C" {
      */
 // #define EXAMPLE_CONSTANT 0
 
+// saturation limits used by asmMainSat, in bits of a signed value.
+// These must match the ASM_SAT_* symbols in asmMult.s.
+#ifndef ASM_SAT_OPERAND_BITS
+#define ASM_SAT_OPERAND_BITS 16
+#endif
+#ifndef ASM_SAT_BITS
+#define ASM_SAT_BITS 31
+#endif
+
+// operand range of asmMultQsq, in bits of an unsigned value.
+// Must match QSQ_OPERAND_BITS in asmQsq.s.
+#ifndef QSQ_OPERAND_BITS
+#define QSQ_OPERAND_BITS 12
+#endif
+
 
     // *****************************************************************************
     // *****************************************************************************
@@ -87,8 +102,59 @@ typedef struct _expectedValues
     int32_t signB;
     int32_t initProduct;
     int32_t finalProduct;
+    int32_t satProduct;   // asmMainSat results
+    int32_t rngError;
+    int32_t prodIsNeg;
 } expectedValues;
 
+// results of one set of asmQ15.s calls on a pair of test vectors
+typedef struct _q15Results
+{
+    uint32_t mul;    // asmQ15Mul(x, y)
+    int32_t mac;     // asmQ15Mac(acc, x, y)
+    uint32_t add;    // asmQ15Add(x, y)
+    uint32_t sub;    // asmQ15Sub(x, y)
+    uint32_t scale;  // asmQ15Scale(x, gain)
+} q15Results;
+
+// Q15 test vectors, tested in every (x, y) combination
+#define NUM_Q15_TEST_VECTORS 10
+extern const uint32_t q15TestVectors[NUM_Q15_TEST_VECTORS];
+
+// largest operand size, in 32 bit words, that testAsmMultN can check
+#define MULTN_MAX_TEST_LIMBS 64
+
+// longest stream testFirFilter can check
+#define FIR_MAX_TEST_VALS 256
+
+// results of one set of asmDiv.s calls on an (n, d) test vector.
+// The unsigned results are for (uint32_t)n and (uint32_t)d.
+typedef struct _divResults
+{
+    int32_t quot;       // asmDiv(n, d)
+    int32_t rem;        // asmMod(n, d)
+    int32_t dmQuot;     // asmDivMod(n, d, &dmRem)
+    int32_t dmRem;
+    uint32_t uQuot;     // asmUDiv(n, d)
+    uint32_t uRem;      // asmUMod(n, d)
+    uint32_t udmQuot;   // asmUDivMod(n, d, &udmRem)
+    uint32_t udmRem;
+} divResults;
+
+typedef struct _divVector
+{
+    int32_t n;
+    int32_t d;
+} divVector;
+
+// (n, d) test vectors for asmDiv..asmUDivMod
+#define NUM_DIV_TEST_VECTORS 20
+extern const divVector divTestVectors[NUM_DIV_TEST_VECTORS];
+
+// divisors for asmUDivConst/asmUDivConstN
+#define NUM_DIV_CONST_DIVISORS 14
+extern const uint32_t divConstDivisors[NUM_DIV_CONST_DIVISORS];
+
 
     // *****************************************************************************
 
@@ -174,6 +240,61 @@ int32_t calcExpectedValues(
         uint32_t packedValue, // test case input
         expectedValues *e);   // ptr to struct where values will be stored
 
+// calcExpectedValues for each of packedVals[0..numVals), into e[0..numVals).
+// e[i] is the expected-value cache entry for test number i.
+void calcExpectedValuesN(
+        const int32_t *packedVals, // test case inputs
+        uint32_t numVals,
+        expectedValues *e);
+
+// C reference models for asmQ15.s
+uint32_t q15MulRef(uint32_t x, uint32_t y);
+int32_t q15MacRef(int32_t acc, uint32_t x, uint32_t y);
+uint32_t q15AddRef(uint32_t x, uint32_t y);
+uint32_t q15SubRef(uint32_t x, uint32_t y);
+uint32_t q15ScaleRef(uint32_t x, int32_t gain);
+// x * y, or x * conj(y) if conj is true; imag on top, real on bottom
+uint32_t q15CmulRef(uint32_t x, uint32_t y, bool conj);
+
+// C reference for asmDot16/asmMac16:
+// acc + sum of x[i].hi*y[i].hi + x[i].lo*y[i].lo
+int64_t calcExpectedDot16(
+        int64_t acc,          // starting accumulator value
+        const uint32_t *x,    // arrays of packed values
+        const uint32_t *y,
+        uint32_t numVals);
+
+// C reference for asmMultN/multN: r[0..2n) = a[0..n) * b[0..n),
+// little-endian 32 bit words
+void calcExpectedMultN(
+        uint32_t *r,
+        const uint32_t *a,
+        const uint32_t *b,
+        uint32_t numLimbs);
+
+// C reference for asmDiv.s: C's / and %, plus the hardware's
+// answers where C leaves them undefined (d == 0, INT32_MIN / -1)
+void calcExpectedDiv(int32_t n, int32_t d, divResults *e);
+
+// C reference for firFilter: direct-form convolution of in[0..n)
+// with h[0..numTaps), starting from all-zero history
+void calcExpectedFir(
+        const int16_t *h,
+        uint32_t numTaps,
+        const int16_t *in,
+        int16_t *out,
+        uint32_t numVals);
+
+// C reference for pukccModMultN: r[0..n) = a * b mod m, a and b < m.
+// Double-and-add over the bits of b, so it doesn't share code with the
+// Barrett reduction it checks.
+void calcExpectedModMultN(
+        uint32_t *r,
+        const uint32_t *a,
+        const uint32_t *b,
+        const uint32_t *m,
+        uint32_t numLimbs);
+
 
 void testAsmUnpack(
         int32_t testNum, // test number
@@ -257,6 +378,180 @@ void testAsmMain(
 
 
 
+// checks every element of an asmMainBatch output array
+void testAsmMainBatch(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * packedVals, // inputs
+        const int32_t * products, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks a 64 bit asmDot16/asmMac16 result
+void testAsmDot16(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t numVals, // inputs
+        int64_t r0r1_result, // outputs
+        int64_t expectedResult, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks both abs values and sign bits from one asmAbsPacked call
+void testAsmAbsPacked(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t packedVal, // inputs
+        uint32_t absPacked, // vals stored in mem
+        uint32_t signBits,
+        uint32_t r0_absPacked, // outputs
+        expectedValues * exp, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks asmMainSat's result and the globals it sets
+void testAsmMainSat(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t packedVal, // inputs
+        int32_t r0_satProd, // outputs
+        int32_t rngError, // vals stored in mem
+        int32_t prodIsNeg,
+        int32_t finalProduct,
+        expectedValues * exp, // expected values
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks all of the asmQ15.s results for one (x, y) pair
+void testAsmQ15(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t x, // inputs
+        uint32_t y,
+        int32_t acc,
+        int32_t gain,
+        q15Results * r0_results, // outputs
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks every element of an asmCmul/asmCmulConj output array
+void testAsmCmul(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * x, // inputs
+        const uint32_t * y,
+        const uint32_t * products, // outputs
+        uint32_t numVals,
+        bool conj, // true: products are x * conj(y)
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks all 2n words of an asmMultN/multN product; nothing if n is 0
+void testAsmMultN(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * a, // inputs
+        const uint32_t * b,
+        const uint32_t * product, // outputs
+        uint32_t numLimbs,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks all of the asmDiv..asmUDivMod results for one (n, d) vector
+void testAsmDiv(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        int32_t n, // inputs
+        int32_t d,
+        divResults * r0_results, // outputs
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks asmMultQsq(a, b[i]) for every element of a product array
+void testAsmMultQsq(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        int32_t a, // inputs
+        const int32_t * b,
+        const int32_t * products, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks a whole filtered stream against calcExpectedFir; nothing if
+// the stream is empty
+void testFirFilter(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const int16_t * h, // inputs
+        uint32_t numTaps,
+        uint32_t blockSize,
+        const int16_t * in,
+        const int16_t * out, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks every element of an asmUDivConst/asmUDivConstN output array
+void testAsmUDivConst(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        uint32_t d, // inputs
+        const uint32_t * dividends,
+        const uint32_t * quotients, // outputs
+        uint32_t numVals,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
+// checks all n words of a pukccModMultN result; nothing if n is 0
+void testPukccModMult(
+        int32_t testNum, // test number
+        char *desc, // optional description, or ""
+        const uint32_t * a, // inputs
+        const uint32_t * b,
+        const uint32_t * m,
+        const uint32_t * result, // outputs
+        uint32_t numLimbs,
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete
+        );
+
 
     /* Provide C++ Compatibility */
 #ifdef __cplusplus
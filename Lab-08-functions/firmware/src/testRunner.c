@@ -0,0 +1,1000 @@
+/* ************************************************************************** */
+/** Table-driven test runner
+
+  @File Name
+    testRunner.c
+
+  @Summary
+    One loop for all the per-test-case kernel tests.
+
+  @Description
+    The adapters here are the only code that knows each kernel's
+    arguments; everything else (LED, pacing, summaries, totals) is shared
+    by every row of the table.
+ */
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+/* Section: Included Files                                                    */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stddef.h>                     // Defines NULL
+#include <stdbool.h>                    // Defines true
+#include <string.h>
+#include <inttypes.h>   // PRIu32 etc.; int32_t is long on XC32, int on a PC
+#include "definitions.h"                // SYS function prototypes
+#include "asmExterns.h"
+#include "testFuncs.h" // lab test structs
+#include "printFuncs.h"  // lab print funcs
+#include "testRunner.h"
+#include "benchFuncs.h"  // benchInit, for the DWT cycle counter
+#include "randVectors.h"
+#include "pukccMult.h"   // pukccPath
+#include "firFilter.h"
+
+
+#define MAX_PRINT_LEN 1000
+
+static uint8_t txBuffer[MAX_PRINT_LEN] = {0};
+
+// packed values per kernel call in sweepPackedInputs
+#define SWEEP_BLOCK_LEN 256
+
+// values between sweepPackedInputs progress lines; a power of 2
+#define SWEEP_REPORT_VALS (1UL << 24)
+
+// mismatches printed in full by sweepPackedInputs, the rest are counted
+#define SWEEP_MAX_PRINTED_FAILS 8
+
+// progress lines go out while the sweep keeps running, so they get
+// their own buffer
+static uint8_t sweepTxBuffer[MAX_PRINT_LEN] = {0};
+
+// the real types of the kernels in the table
+typedef void (*unpackFunc)(uint32_t packedValue, int32_t *a, int32_t *b);
+typedef int32_t (*absFunc)(int32_t input, int32_t *absOut, int32_t *signBit);
+typedef int32_t (*multFunc)(int32_t a, int32_t b);
+typedef int32_t (*fixSignFunc)(int32_t initProduct, int32_t signBitA, int32_t signBitB);
+typedef int32_t (*mainFunc)(uint32_t packedValue);
+typedef uint32_t (*absPackedFunc)(uint32_t packed, uint32_t *absPacked, uint32_t *signBits);
+typedef int32_t (*mainCtxFunc)(uint32_t packedValue, mult_ctx_t *ctx);
+typedef int64_t (*dot16Func)(const uint32_t *x, const uint32_t *y, size_t n);
+typedef int64_t (*mac16Func)(int64_t acc, const uint32_t *x, const uint32_t *y, size_t n);
+typedef void (*cmulFunc)(const uint32_t *x, const uint32_t *y, uint32_t *out, size_t n);
+typedef void (*multNFunc)(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+typedef void (*karatsubaFunc)(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n,
+        uint32_t *scratch, size_t threshold);
+typedef pukccPath (*pukccMultFunc)(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+typedef pukccPath (*pukccModMultFunc)(uint32_t *r, const uint32_t *a, const uint32_t *b,
+        const uint32_t *m, size_t n);
+typedef uint32_t (*udivConstFunc)(uint32_t n, const divMagic *m);
+typedef void (*udivConstNFunc)(const uint32_t *in, uint32_t *out, size_t n, const divMagic *m);
+typedef void (*firProcessFunc)(firFilter *f, const int16_t *in, int16_t *out, size_t n);
+
+// longest tc[] prefix the array adapters pass in one call
+#define PREFIX_MAX_VALS 32
+
+// asmMac16's starting accumulator; big enough to need both words
+#define MAC16_START_ACC (-1234567890123LL)
+
+// multipliers per multiplicand in the asmMultQsq cases
+#define QSQ_TEST_VALS 32
+
+// dividends per divisor in the asmUDivConst cases
+#define DIV_CONST_VALS 16
+
+// samples per stream and largest filter in the FIR cases
+#define FIR_TEST_VALS 200
+#define FIR_TEST_MAX_TAPS 16
+
+// operand sizes of the multi-precision cases. Odd sizes make Karatsuba
+// split unevenly; the PUKCC sizes are on both sides of
+// PUKCC_DEFAULT_MIN_LIMBS, so both paths are tested.
+static const uint32_t multNSizes[MULTN_TEST_CASES / 2] =
+        { 1, 2, 3, 5, 8, 17, 33, MULTN_MAX_TEST_LIMBS };
+static const uint32_t pukccSizes[PUKCC_TEST_CASES] =
+        { 4, 15, 16, 32, MULTN_MAX_TEST_LIMBS };
+
+// seeds of the adapters' random inputs. Each case starts from its own
+// seed + testNum, so any case gives the same inputs when run on its own.
+#define QSQ_TEST_SEED       0x51515151
+#define MULTN_TEST_SEED     0x2468ACE1
+#define PUKCC_TEST_SEED     0x13579BDF
+#define DIV_CONST_TEST_SEED 0xC0FFEE11
+#define FIR_TEST_SEED       0xF1F1F1F1
+
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+// Section: Interface Functions                                               */
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+void checkUnpackCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    int32_t unpackedA = 0;
+    int32_t unpackedB = 0;
+
+    ((unpackFunc)t->kernel)(exp->packedVal, &unpackedA, &unpackedB);
+    testAsmUnpack(testNum, "", exp->packedVal,
+            &unpackedA, &unpackedB,
+            exp->inputA, exp->inputB,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkAbsCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    int32_t absVal = 0;
+    int32_t signBit = 0;
+    int32_t pass = 0;
+    int32_t fail = 0;
+
+    // A, then B. The checker resets its counts, so add them up here.
+    int32_t r0_absValA = ((absFunc)t->kernel)(exp->inputA, &absVal, &signBit);
+    testAsmAbs(testNum, "", exp->inputA, &absVal, &signBit, r0_absValA,
+            exp->absA, exp->signA,
+            &pass, &fail, onlyPrintFails, txComplete);
+    *passCount = pass;
+    *failCount = fail;
+
+    absVal = 0;
+    signBit = 0;
+    int32_t r0_absValB = ((absFunc)t->kernel)(exp->inputB, &absVal, &signBit);
+    testAsmAbs(testNum, "", exp->inputB, &absVal, &signBit, r0_absValB,
+            exp->absB, exp->signB,
+            &pass, &fail, onlyPrintFails, txComplete);
+    *passCount += pass;
+    *failCount += fail;
+}
+
+void checkMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    int32_t r0_initProd = ((multFunc)t->kernel)(exp->absA, exp->absB);
+    testAsmMult(testNum, "", exp->absA, exp->absB,
+            r0_initProd, exp->initProduct,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkFixSignCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // the correct product goes in; only the sign fix is being tested
+    int32_t r0_finalProduct = ((fixSignFunc)t->kernel)(exp->initProduct,
+            exp->signA, exp->signB);
+    testAsmFixSign(testNum, "", exp->initProduct, exp->signA, exp->signB,
+            r0_finalProduct, exp->finalProduct,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkMainCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    int32_t r0_mainFinalProd = ((mainFunc)t->kernel)(exp->packedVal);
+    testAsmMain(testNum, "", exp->packedVal,
+            r0_mainFinalProd,
+            a_Multiplicand, b_Multiplier, // vals stored in mem
+            a_Abs, a_Sign, b_Abs, b_Sign,
+            init_Product, final_Product,
+            exp,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+void checkAbsPackedCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    uint32_t absPacked = 0;
+    uint32_t signBits = 0;
+
+    uint32_t r0_absPacked = ((absPackedFunc)t->kernel)(exp->packedVal,
+            &absPacked, &signBits);
+    testAsmAbsPacked(testNum, "", exp->packedVal, absPacked, signBits,
+            r0_absPacked, exp,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkMultSwappedCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // for kernels like asmMultClz that order the operands themselves
+    int32_t r0_baProd = ((multFunc)t->kernel)(exp->absB, exp->absA);
+    testAsmMult(testNum, "(b,a)", exp->absB, exp->absA,
+            r0_baProd, exp->initProduct,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkMainCtxCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // the struct values come from a call with a ctx, the returned value
+    // from a call without one, so both paths get checked
+    mult_ctx_t ctx = {0};
+    (void)((mainCtxFunc)t->kernel)(exp->packedVal, &ctx);
+    int32_t r0_ctxFinalProd = ((mainCtxFunc)t->kernel)(exp->packedVal, NULL);
+    testAsmMain(testNum, "", exp->packedVal,
+            r0_ctxFinalProd,
+            ctx.a_Multiplicand, ctx.b_Multiplier, // vals stored in the struct
+            ctx.a_Abs, ctx.a_Sign, ctx.b_Abs, ctx.b_Sign,
+            ctx.init_Product, ctx.final_Product,
+            exp,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkMainSatCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // set the globals to values the kernel must overwrite
+    rng_Error = -1;
+    prod_Is_Neg = -1;
+    final_Product = 0x5A5A5A5A;
+    int32_t r0_satProd = ((mainFunc)t->kernel)(exp->packedVal);
+    testAsmMainSat(testNum, "", exp->packedVal,
+            r0_satProd,
+            rng_Error, prod_Is_Neg, final_Product, // vals stored in mem
+            exp,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// packed values of tc[0..testNum] into packed[], for the array kernels.
+// Returns how many, at most PREFIX_MAX_VALS.
+static uint32_t prefixPackedVals(int32_t testNum, const expectedValues *exp,
+        uint32_t *packed)
+{
+    uint32_t n = (uint32_t)testNum + 1;
+    if (n > PREFIX_MAX_VALS)
+    {
+        n = PREFIX_MAX_VALS;
+    }
+    const expectedValues *first = exp + 1 - n;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        packed[i] = first[i].packedVal;
+    }
+    return n;
+}
+
+void checkMainBatchCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t packed[PREFIX_MAX_VALS];
+    static int32_t products[PREFIX_MAX_VALS];
+
+    uint32_t n = prefixPackedVals(testNum, exp, packed);
+    ((packedBatchFunc)t->kernel)(packed, products, n);
+    testAsmMainBatch(testNum, "", packed, products, n,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkDot16Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t x[PREFIX_MAX_VALS];
+
+    // sum of squares of every half
+    uint32_t n = prefixPackedVals(testNum, exp, x);
+    int64_t r0r1_dot = ((dot16Func)t->kernel)(x, x, n);
+    testAsmDot16(testNum, "", n, r0r1_dot, calcExpectedDot16(0, x, x, n),
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkMac16Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t x[PREFIX_MAX_VALS];
+
+    // each value times the next one, on top of a non-zero accumulator.
+    // n runs from 0 up, so the empty and odd-length paths both run.
+    uint32_t n = prefixPackedVals(testNum, exp, x) - 1;
+    int64_t r0r1_mac = ((mac16Func)t->kernel)(MAC16_START_ACC, x, x + 1, n);
+    testAsmDot16(testNum, "", n, r0r1_mac,
+            calcExpectedDot16(MAC16_START_ACC, x, x + 1, n),
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// next value of the LCG the adapters make their random inputs with
+static uint32_t lcgNext(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed;
+}
+
+void checkMultQsqCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // every edge of the table, then random operands. The tc[] operands
+    // go up to 32768, past the table, so this row can't use them.
+    const int32_t qsqMax = (1 << QSQ_OPERAND_BITS) - 1;
+    const int32_t edges[] = { 0, 1, 2, 3, 255, 256, qsqMax - 1, qsqMax };
+    const uint32_t numEdges = sizeof(edges)/sizeof(edges[0]);
+    static int32_t b[QSQ_TEST_VALS];
+    static int32_t products[QSQ_TEST_VALS];
+    uint32_t seed = QSQ_TEST_SEED + testNum;
+
+    int32_t a = ((uint32_t)testNum < numEdges) ? edges[testNum]
+            : (int32_t)(lcgNext(&seed) >> 16) & qsqMax;
+    for (uint32_t i = 0; i < QSQ_TEST_VALS; ++i)
+    {
+        b[i] = (i < numEdges) ? edges[i] : (int32_t)(lcgNext(&seed) >> 16) & qsqMax;
+        products[i] = ((multFunc)t->kernel)(a, b[i]);
+    }
+    testAsmMultQsq(testNum, "", a, b, products, QSQ_TEST_VALS,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkQ15Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // every pair of Q15 test vectors. The accumulator and gain come from
+    // the vectors too, so the saturating cases get hit.
+    uint32_t x = q15TestVectors[testNum / NUM_Q15_TEST_VECTORS];
+    uint32_t y = q15TestVectors[testNum % NUM_Q15_TEST_VECTORS];
+    int32_t acc = (int32_t)(x ^ (y << 1));
+    int32_t gain = (int16_t)y;
+    q15Results r0_results;
+
+    ((q15GroupFunc)t->kernel)(x, y, acc, gain, &r0_results);
+    testAsmQ15(testNum, "", x, y, acc, gain, &r0_results,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// each Q15 test vector times the one testNum places on, as complex values
+static void cmulCase(const kernelTest *t, int32_t testNum, bool conj,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t y[NUM_Q15_TEST_VECTORS];
+    static uint32_t products[NUM_Q15_TEST_VECTORS];
+
+    for (uint32_t i = 0; i < NUM_Q15_TEST_VECTORS; ++i)
+    {
+        y[i] = q15TestVectors[(i + testNum) % NUM_Q15_TEST_VECTORS];
+    }
+    ((cmulFunc)t->kernel)(q15TestVectors, y, products, NUM_Q15_TEST_VECTORS);
+    testAsmCmul(testNum, "", q15TestVectors, y, products,
+            NUM_Q15_TEST_VECTORS, conj,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkCmulCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    cmulCase(t, testNum, false, passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkCmulConjCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    cmulCase(t, testNum, true, passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// operands for multi-precision case testNum: even cases are all ones,
+// the worst case for carries, odd cases random. Returns the size.
+static uint32_t multNOperands(int32_t testNum, uint32_t *a, uint32_t *b)
+{
+    uint32_t n = multNSizes[testNum / 2];
+    uint32_t seed = MULTN_TEST_SEED + testNum;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        a[i] = ((testNum % 2) == 0) ? 0xFFFFFFFF : lcgNext(&seed);
+        b[i] = ((testNum % 2) == 0) ? 0xFFFFFFFF : lcgNext(&seed);
+    }
+    return n;
+}
+
+void checkMultNCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t a[MULTN_MAX_TEST_LIMBS];
+    static uint32_t b[MULTN_MAX_TEST_LIMBS];
+    static uint32_t product[2 * MULTN_MAX_TEST_LIMBS];
+
+    uint32_t n = multNOperands(testNum, a, b);
+    ((multNFunc)t->kernel)(product, a, b, n);
+    testAsmMultN(testNum, "", a, b, product, n,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkKaratsubaCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t a[MULTN_MAX_TEST_LIMBS];
+    static uint32_t b[MULTN_MAX_TEST_LIMBS];
+    static uint32_t product[2 * MULTN_MAX_TEST_LIMBS];
+    // enough for any n <= MULTN_MAX_TEST_LIMBS with threshold 2
+    static uint32_t scratch[5 * MULTN_MAX_TEST_LIMBS];
+
+    // threshold 2 forces Karatsuba all the way down
+    uint32_t n = multNOperands(testNum, a, b);
+    ((karatsubaFunc)t->kernel)(product, a, b, n, scratch, 2);
+    testAsmMultN(testNum, "", a, b, product, n,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// operands for PUKCC case testNum: an odd modulus with the top bit set,
+// and a, b < m. Returns the size.
+static uint32_t pukccOperands(int32_t testNum, uint32_t *a, uint32_t *b, uint32_t *m)
+{
+    uint32_t n = pukccSizes[testNum];
+    uint32_t seed = PUKCC_TEST_SEED + testNum;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        a[i] = lcgNext(&seed);
+        b[i] = lcgNext(&seed);
+        m[i] = lcgNext(&seed);
+    }
+    m[0] |= 1;
+    m[n - 1] |= 0x80000000;
+    a[n - 1] &= 0x7FFFFFFF;
+    b[n - 1] &= 0x7FFFFFFF;
+    return n;
+}
+
+void checkPukccMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t a[MULTN_MAX_TEST_LIMBS];
+    static uint32_t b[MULTN_MAX_TEST_LIMBS];
+    static uint32_t m[MULTN_MAX_TEST_LIMBS];
+    static uint32_t product[2 * MULTN_MAX_TEST_LIMBS];
+
+    // which path ran is in pukccHwCalls/pukccErrors; only the answer
+    // is checked here
+    uint32_t n = pukccOperands(testNum, a, b, m);
+    (void)((pukccMultFunc)t->kernel)(product, a, b, n);
+    testAsmMultN(testNum, "", a, b, product, n,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkPukccModMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t a[MULTN_MAX_TEST_LIMBS];
+    static uint32_t b[MULTN_MAX_TEST_LIMBS];
+    static uint32_t m[MULTN_MAX_TEST_LIMBS];
+    static uint32_t result[MULTN_MAX_TEST_LIMBS];
+
+    uint32_t n = pukccOperands(testNum, a, b, m);
+    (void)((pukccModMultFunc)t->kernel)(result, a, b, m, n);
+    testPukccModMult(testNum, "", a, b, m, result, n,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkDivCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    int32_t n = divTestVectors[testNum].n;
+    int32_t d = divTestVectors[testNum].d;
+    divResults r0_results;
+
+    ((divGroupFunc)t->kernel)(n, d, &r0_results);
+    testAsmDiv(testNum, "", n, d, &r0_results,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// dividends for divide-by-constant case testNum: edge cases around the
+// divisor, then random values. Returns the divisor.
+static uint32_t divConstOperands(int32_t testNum, uint32_t *dividends, divMagic *m)
+{
+    uint32_t d = divConstDivisors[testNum];
+    const uint32_t edges[] = { 0, 1, d - 1, d, d + 1,
+            0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF };
+    const uint32_t numEdges = sizeof(edges)/sizeof(edges[0]);
+    uint32_t seed = DIV_CONST_TEST_SEED + testNum;
+
+    for (uint32_t i = 0; i < DIV_CONST_VALS; ++i)
+    {
+        dividends[i] = (i < numEdges) ? edges[i] : lcgNext(&seed);
+    }
+    divMagicInit(m, d);
+    return d;
+}
+
+void checkUDivConstCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t dividends[DIV_CONST_VALS];
+    static uint32_t quotients[DIV_CONST_VALS];
+    divMagic m;
+
+    uint32_t d = divConstOperands(testNum, dividends, &m);
+    for (uint32_t i = 0; i < DIV_CONST_VALS; ++i)
+    {
+        quotients[i] = ((udivConstFunc)t->kernel)(dividends[i], &m);
+    }
+    testAsmUDivConst(testNum, "", d, dividends, quotients, DIV_CONST_VALS,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkUDivConstNCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    static uint32_t dividends[DIV_CONST_VALS];
+    static uint32_t quotients[DIV_CONST_VALS];
+    divMagic m;
+
+    uint32_t d = divConstOperands(testNum, dividends, &m);
+    ((udivConstNFunc)t->kernel)(dividends, quotients, DIV_CONST_VALS, &m);
+    testAsmUDivConst(testNum, "", d, dividends, quotients, DIV_CONST_VALS,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+void checkFirCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete)
+{
+    // the same stream through each filter in different block sizes, so
+    // the history has to carry across calls
+    static const int16_t identity[] = { 0x7FFF };
+    static const int16_t average4[] = { 0x2000, 0x2000, 0x2000, 0x2000 };
+    static const int16_t lowpass7[] = { -1000, 2000, 8000, 12000, 8000, 2000, -1000 };
+    static int16_t random16[FIR_TEST_MAX_TAPS];
+    const struct
+    {
+        char *name;
+        const int16_t *h;
+        uint32_t numTaps;
+    } filters[] = {
+        { "identity", identity, 1 },
+        { "average4", average4, 4 },
+        { "lowpass7", lowpass7, 7 },
+        { "random16", random16, FIR_TEST_MAX_TAPS },
+    };
+    static const uint32_t blockSizes[] = { 1, 7, 64, FIR_TEST_VALS };
+    const uint32_t numBlockSizes = sizeof(blockSizes)/sizeof(blockSizes[0]);
+    static int16_t in[FIR_TEST_VALS];
+    static int16_t out[FIR_TEST_VALS];
+    static uint32_t coefBuf[FIR_COEF_WORDS(FIR_TEST_MAX_TAPS)];
+    static uint32_t stateBuf[FIR_STATE_WORDS(FIR_TEST_MAX_TAPS)];
+    firFilter f;
+
+    // the random filter and the stream are the same for every case
+    uint32_t seed = FIR_TEST_SEED;
+    for (uint32_t k = 0; k < FIR_TEST_MAX_TAPS; ++k)
+    {
+        random16[k] = (int16_t)(lcgNext(&seed) >> 16) / FIR_TEST_MAX_TAPS;
+    }
+    for (uint32_t i = 0; i < FIR_TEST_VALS; ++i)
+    {
+        in[i] = (int16_t)(lcgNext(&seed) >> 16);
+    }
+
+    uint32_t k = testNum / numBlockSizes;
+    uint32_t blockSize = blockSizes[testNum % numBlockSizes];
+    firInit(&f, filters[k].h, filters[k].numTaps, coefBuf, stateBuf);
+    for (uint32_t i = 0; i < FIR_TEST_VALS; i += blockSize)
+    {
+        uint32_t n = FIR_TEST_VALS - i;
+        n = (n < blockSize) ? n : blockSize;
+        ((firProcessFunc)t->kernel)(&f, &in[i], &out[i], n);
+    }
+    testFirFilter(testNum, filters[k].name, filters[k].h, filters[k].numTaps,
+            blockSize, in, out, FIR_TEST_VALS,
+            passCount, failCount, onlyPrintFails, txComplete);
+}
+
+
+// one summary for a whole turbo run. Rows are added to the buffer until
+// it is nearly full, so a long table still goes out in a few prints.
+static void printTurboSummary(
+        const kernelTest *tests,
+        const kernelTestResults *results,
+        uint32_t numKernels,
+        uint32_t elapsedCycles,
+        volatile bool *txComplete)
+{
+    const uint32_t cyclesPerMs = CPU_CLOCK_FREQUENCY / 1000;
+    int len = snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= TURBO TESTS COMPLETE: %" PRIu32 " ms (%" PRIu32 " cycles) wall clock\r\n"
+            "cycles/case are kernel + checker; see microBench for the kernel alone\r\n"
+            "kernel           passed   check cycles/case: min      avg      max\r\n",
+            elapsedCycles / cyclesPerMs, elapsedCycles);
+
+    for (uint32_t k = 0; k < numKernels; ++k)
+    {
+        const kernelTestResults *r = &results[k];
+        if (*tests[k].enabled == false)
+        {
+            continue;
+        }
+        uint32_t avgCycles = 0;
+        if (r->numCases != 0)
+        {
+            avgCycles = r->totalCycles / r->numCases;
+        }
+        if (len > MAX_PRINT_LEN - 100)
+        {
+            printAndWait((char*)txBuffer, txComplete);
+            len = 0;
+        }
+        len += snprintf((char*)txBuffer + len, MAX_PRINT_LEN - len,
+                "%-15s %4" PRId32 "/%-4" PRId32 " %22" PRIu32 " %8" PRIu32 " %8" PRIu32 "\r\n",
+                tests[k].name, r->passCount, r->numTests,
+                r->minCycles, avgCycles, r->maxCycles);
+    }
+    snprintf((char*)txBuffer + len, MAX_PRINT_LEN - len, "\r\n");
+    printAndWait((char*)txBuffer, txComplete);
+}
+
+
+uint32_t runKernelTests(
+        const kernelTest *tests,
+        kernelTestResults *results,
+        uint32_t numKernels,
+        expectedValues *expected,
+        uint32_t numTestCases,
+        bool onlyPrintFails,
+        bool turbo,
+        volatile bool *rtcExpired,
+        volatile bool *txComplete)
+{
+    benchInit();
+    uint32_t runStart = DWT->CYCCNT;
+
+    for (uint32_t k = 0; k < numKernels; ++k)
+    {
+        const kernelTest *t = &tests[k];
+        kernelTestResults *r = &results[k];
+
+        r->passCount = 0;
+        r->failCount = 0;
+        r->numTests = 0;
+        r->numCases = 0;
+        r->minCycles = UINT32_MAX;
+        r->maxCycles = 0;
+        r->totalCycles = 0;
+        if (*t->enabled == false)
+        {
+            continue;
+        }
+
+        // rows with their own cases get no tc[] entry
+        uint32_t rowCases = (t->numCases != 0) ? t->numCases : numTestCases;
+        for (uint32_t testCase = 0; testCase < rowCases; ++testCase)
+        {
+            // Toggle the LED to show we're running a new test case
+            LED0_Toggle();
+
+            // reset the state variables for the timer and serial port funcs
+            *rtcExpired = false;
+            *txComplete = false;
+
+            int32_t passCount = 0;
+            int32_t failCount = 0;
+            expectedValues *exp = (t->numCases != 0) ? NULL : &expected[testCase];
+            // times the whole adapter, checker included
+            uint32_t start = DWT->CYCCNT;
+            t->check(t, testCase, exp,
+                    &passCount, &failCount, onlyPrintFails, txComplete);
+            uint32_t cycles = DWT->CYCCNT - start;
+
+            r->passCount += passCount;
+            r->failCount += failCount;
+            r->numTests = r->passCount + r->failCount;
+            r->numCases += 1;
+            r->totalCycles += cycles;
+            if (cycles < r->minCycles)
+            {
+                r->minCycles = cycles;
+            }
+            if (cycles > r->maxCycles)
+            {
+                r->maxCycles = cycles;
+            }
+
+            if (turbo == true)
+            {
+                continue;
+            }
+
+            snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                    "========= %s In-progress test summary:\r\n"
+                    "%" PRId32 " of %" PRId32 " tests passed so far...\r\n"
+                    "\r\n",
+                    t->name, r->passCount, r->numTests);
+            printAndWait((char*)txBuffer, txComplete);
+
+            // spin here until the LED toggle timer has expired. This allows
+            // the test cases to be spread out in time.
+            while (*rtcExpired == false);
+        } // end: loop on all test cases for this kernel
+
+        if (turbo == true)
+        {
+            continue;
+        }
+
+        snprintf((char*)txBuffer, MAX_PRINT_LEN,
+                "========= %s TESTS COMPLETE: \r\n"
+                "Summary of tests: %" PRId32 " of %" PRId32 " tests passed\r\n"
+                "\r\n",
+                t->name, r->passCount, r->numTests);
+        printAndWait((char*)txBuffer, txComplete);
+    } // end: loop on all kernels
+
+    uint32_t elapsedCycles = DWT->CYCCNT - runStart;
+    if (turbo == true)
+    {
+        printTurboSummary(tests, results, numKernels, elapsedCycles, txComplete);
+    }
+    return elapsedCycles;
+}
+
+// print one sweep or random-test mismatch in full. Waits for a progress
+// line that may still be going out, since both use DMA channel 0.
+static void printPackedFail(
+        const char *name,
+        uint32_t packedVal,
+        int32_t product,
+        bool *progressBusy,
+        volatile bool *txComplete)
+{
+    static expectedValues exp;
+
+    if (*progressBusy == true)
+    {
+        while (*txComplete == false);
+        *progressBusy = false;
+    }
+    calcExpectedValues(0, "", packedVal, &exp);
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= %s MISMATCH\r\n"
+            "packed (input) value: 0x%08" PRIx32 "\r\n"
+            "a, b:                 %11" PRId32 " %11" PRId32 "\r\n"
+            "expected product:     %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "returned product:     %11" PRId32 "; 0x%08" PRIx32 "\r\n"
+            "\r\n",
+            name, packedVal,
+            exp.inputA, exp.inputB,
+            exp.finalProduct, exp.finalProduct,
+            product, product);
+    printAndWait((char*)txBuffer, txComplete);
+}
+
+
+// compare products[0..n) with the expected products of packed[0..n).
+// The hot loop of the sweep and random tests: this is calcExpectedValues'
+// finalProduct (inputA * inputB) without the rest of the struct; a
+// mismatch is re-checked with calcExpectedValues when it's printed.
+// Returns the number of mismatches in this block.
+static uint32_t checkPackedBlock(
+        const char *name,
+        const uint32_t *packed,
+        const int32_t *products,
+        uint32_t n,
+        sweepResults *r,
+        bool *progressBusy,
+        volatile bool *txComplete)
+{
+    uint32_t blockFails = 0;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        int32_t expected = (int32_t)(int16_t)(packed[i] >> 16)
+                * (int16_t)packed[i];
+        if (products[i] != expected)
+        {
+            if (r->mismatches < SWEEP_MAX_PRINTED_FAILS)
+            {
+                printPackedFail(name, packed[i], products[i],
+                        progressBusy, txComplete);
+            }
+            if (r->mismatches != UINT32_MAX)
+            {
+                r->mismatches += 1;
+            }
+            blockFails += 1;
+        }
+    }
+    return blockFails;
+}
+
+
+void sweepPackedInputs(
+        packedBatchFunc kernel,
+        const char *name,
+        uint32_t stride,
+        sweepResults *r,
+        volatile bool *txComplete)
+{
+    static uint32_t packed[SWEEP_BLOCK_LEN];
+    static int32_t products[SWEEP_BLOCK_LEN];
+    const uint64_t end = 1ULL << 32;   // one past the last packed value
+    const uint64_t cyclesPerSec = CPU_CLOCK_FREQUENCY;
+    bool progressBusy = false;  // a progress line may still be going out
+    uint64_t next = 0;          // next packed value to check
+    uint64_t nextReport = SWEEP_REPORT_VALS;
+
+    if (stride == 0)
+    {
+        stride = 1;
+    }
+    r->numVals = 0;
+    r->mismatches = 0;
+    r->cycles = 0;
+
+    benchInit();
+    uint32_t reportStart = DWT->CYCCNT;
+    uint64_t reportVals = 0;
+
+    while (next < end)
+    {
+        // the last block may be short
+        uint32_t n = SWEEP_BLOCK_LEN;
+        if ((end - next + stride - 1) / stride < n)
+        {
+            n = (uint32_t)((end - next + stride - 1) / stride);
+        }
+        uint32_t p = (uint32_t)next;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            packed[i] = p;
+            p += stride;
+        }
+        next += (uint64_t)n * stride;
+
+        kernel(packed, products, n);
+
+        checkPackedBlock(name, packed, products, n, r, &progressBusy, txComplete);
+        r->numVals += n;
+        reportVals += n;
+
+        if ((r->numVals >= nextReport) || (next >= end))
+        {
+            uint32_t cycles = DWT->CYCCNT - reportStart;
+            reportStart += cycles;
+            r->cycles += cycles;
+            nextReport += SWEEP_REPORT_VALS;
+
+            // skip this line if the last one is still going out
+            if ((progressBusy == false) || (*txComplete == true))
+            {
+                uint32_t valsPerSec = 0;
+                if (cycles != 0)
+                {
+                    valsPerSec = (uint32_t)(reportVals * cyclesPerSec / cycles);
+                }
+                snprintf((char*)sweepTxBuffer, MAX_PRINT_LEN,
+                        "%s sweep: at 0x%08" PRIx32 ", %" PRIu32 " k of %" PRIu32 " k values, %" PRIu32 " mismatches, %" PRIu32 " values/sec\r\n",
+                        name, (uint32_t)(next - stride),
+                        (uint32_t)(r->numVals / 1000),
+                        (uint32_t)(((end + stride - 1) / stride) / 1000),
+                        r->mismatches, valsPerSec);
+                printNoWait((char*)sweepTxBuffer, txComplete);
+                progressBusy = true;
+            }
+            reportVals = 0;
+            LED0_Toggle();
+        }
+    } // end: loop on all packed values
+
+    if (progressBusy == true)
+    {
+        while (*txComplete == false);
+    }
+    // from the cycle count, not whole seconds, so a short sweep still
+    // gets a rate. numVals <= 2^32 and cyclesPerSec < 2^27, so the
+    // product fits in 64 bits.
+    uint32_t ms = (uint32_t)(r->cycles * 1000 / cyclesPerSec);
+    uint32_t valsPerSec = 0;
+    if (r->cycles != 0)
+    {
+        valsPerSec = (uint32_t)(r->numVals * cyclesPerSec / r->cycles);
+    }
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= %s SWEEP COMPLETE: stride %" PRIu32 "\r\n"
+            "%" PRIu32 " k values checked, %" PRIu32 " mismatches\r\n"
+            "%" PRIu32 " ms, %" PRIu32 " values/sec\r\n"
+            "\r\n",
+            name, stride,
+            (uint32_t)(r->numVals / 1000), r->mismatches,
+            ms, valsPerSec);
+    printAndWait((char*)txBuffer, txComplete);
+}
+
+void randomPackedTests(
+        packedBatchFunc kernel,
+        const char *name,
+        uint32_t seed,
+        uint32_t numBatches,
+        sweepResults *r,
+        volatile bool *txComplete)
+{
+    static uint32_t packed[SWEEP_BLOCK_LEN];
+    static int32_t products[SWEEP_BLOCK_LEN];
+    static randVectors rv;
+    const uint64_t cyclesPerSec = CPU_CLOCK_FREQUENCY;
+    bool progressBusy = false;  // never set; printPackedFail wants it
+    uint32_t firstBadBatch = UINT32_MAX;
+
+    if (seed == 0)
+    {
+        seed = randSeedFromTrng();
+    }
+    randVectorsInit(&rv, seed);
+    r->numVals = 0;
+    r->mismatches = 0;
+    r->cycles = 0;
+
+    snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= %s random tests: seed 0x%08" PRIx32 ", %" PRIu32 " values\r\n"
+            "set RANDOM_TEST_SEED to 0x%08" PRIx32 " in main.c to replay this run\r\n"
+            "\r\n",
+            name, seed, numBatches * SWEEP_BLOCK_LEN, seed);
+    printAndWait((char*)txBuffer, txComplete);
+
+    benchInit();
+    uint32_t start = DWT->CYCCNT;
+    for (uint32_t b = 0; b < numBatches; ++b)
+    {
+        randVectorsFill(&rv, packed, SWEEP_BLOCK_LEN);
+        kernel(packed, products, SWEEP_BLOCK_LEN);
+        if ((checkPackedBlock(name, packed, products, SWEEP_BLOCK_LEN, r,
+                &progressBusy, txComplete) != 0) && (firstBadBatch == UINT32_MAX))
+        {
+            firstBadBatch = b;
+        }
+        r->numVals += SWEEP_BLOCK_LEN;
+    }
+    r->cycles = DWT->CYCCNT - start;
+
+    uint32_t valsPerSec = 0;
+    if (r->cycles != 0)
+    {
+        valsPerSec = (uint32_t)(r->numVals * cyclesPerSec / r->cycles);
+    }
+    int len = snprintf((char*)txBuffer, MAX_PRINT_LEN,
+            "========= %s RANDOM TESTS COMPLETE: seed 0x%08" PRIx32 "\r\n"
+            "%" PRIu32 " values checked, %" PRIu32 " mismatches, %" PRIu32 " values/sec\r\n",
+            name, seed,
+            (uint32_t)r->numVals, r->mismatches, valsPerSec);
+    if (firstBadBatch != UINT32_MAX)
+    {
+        len += snprintf((char*)txBuffer + len, MAX_PRINT_LEN - len,
+                "first mismatch in batch %" PRIu32 " (values %" PRIu32 "..%" PRIu32 " of the sequence)\r\n",
+                firstBadBatch, firstBadBatch * SWEEP_BLOCK_LEN,
+                (firstBadBatch + 1) * SWEEP_BLOCK_LEN - 1);
+    }
+    snprintf((char*)txBuffer + len, MAX_PRINT_LEN - len, "\r\n");
+    printAndWait((char*)txBuffer, txComplete);
+}
+
+/* *****************************************************************************
+ End of File
+ */
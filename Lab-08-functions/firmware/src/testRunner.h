@@ -0,0 +1,272 @@
+/* ************************************************************************** */
+/** Table-driven test runner
+
+  @File Name
+    testRunner.h
+
+  @Summary
+    Runs every kernel in a table against every tc[] test case, and
+    runs asmMain-style kernels over the whole packed input space or
+    over random packed values.
+
+  @Description
+    Each row of the table names a kernel, points at it, and points at
+    the adapter that calls it for one test case and hands the result to
+    its testFuncs.c checker. runKernelTests walks the table and adds the
+    pass/fail counts of each row into a results array, so a new kernel
+    with the same shape as an existing one is one more row in main.c.
+
+    Most rows run once per tc[] case. Kernels whose inputs aren't packed
+    pairs (Q15 vectors, wide operands, divisors, filters) have their own
+    numbered cases instead: the row says how many, and the adapter makes
+    the inputs for case testNum itself.
+ */
+/* ************************************************************************** */
+
+#ifndef _TEST_RUNNER_H    /* Guard against multiple inclusion */
+#define _TEST_RUNNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "testFuncs.h"
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Constants
+    // *****************************************************************************
+    // *****************************************************************************
+
+// numCases for the rows whose adapters make their own inputs
+#define QSQ_TEST_CASES   16   // multiplicands: 8 table edges, 8 random
+#define Q15_TEST_CASES   (NUM_Q15_TEST_VECTORS * NUM_Q15_TEST_VECTORS)
+#define CMUL_TEST_CASES  NUM_Q15_TEST_VECTORS   // rotations of the vectors
+#define MULTN_TEST_CASES 16   // 8 sizes, all-ones and random operands
+#define PUKCC_TEST_CASES 5    // sizes on both sides of the PUKCC threshold
+#define DIV_TEST_CASES   NUM_DIV_TEST_VECTORS
+#define DIV_CONST_TEST_CASES NUM_DIV_CONST_DIVISORS
+#define FIR_TEST_CASES   16   // 4 filters, 4 block sizes each
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Data Types
+    // *****************************************************************************
+    // *****************************************************************************
+
+// any kernel. The adapter in the same row casts it back to its real type.
+typedef void (*kernelFunc)(void);
+
+struct _kernelTest;
+
+// call t->kernel for one test case and check it against exp.
+// For a row with numCases == 0, exp is &expected[testNum], so the
+// cases before it are exp - testNum .. exp - 1. For a row with its own
+// cases, exp is NULL.
+typedef void (*kernelCheckFunc)(
+        const struct _kernelTest *t,
+        int32_t testNum, // test number
+        expectedValues *exp, // inputs and expected values for testNum
+        int32_t * passCount,
+        int32_t * failCount,
+        bool onlyPrintFails,
+        volatile bool * txComplete);
+
+// one row of the kernel test table
+typedef struct _kernelTest
+{
+    const char *name;      // used in the summaries, e.g. "asmUnpack"
+    kernelFunc kernel;
+    kernelCheckFunc check; // one of the checkXxxCase adapters below
+    bool *enabled;         // the row is skipped when *enabled is false
+    uint32_t numCases;     // 0: one case per tc[] case; otherwise this
+                           // many of the adapter's own cases
+} kernelTest;
+
+// pass/fail totals for one row of the table
+typedef struct _kernelTestResults
+{
+    int32_t passCount;
+    int32_t failCount;
+    int32_t numTests;      // passCount + failCount
+    uint32_t numCases;     // test cases run
+    // DWT cycles per test case: adapter setup, kernel and checker, so a
+    // case that fails includes the time to print it
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t totalCycles;
+} kernelTestResults;
+
+
+// kernels tested as a group, through one C function that calls each of
+// them once and fills in the results struct its checker takes
+typedef void (*q15GroupFunc)(uint32_t x, uint32_t y, int32_t acc, int32_t gain,
+        q15Results *r);   // asmQ15Mul .. asmQ15Scale
+typedef void (*divGroupFunc)(int32_t n, int32_t d,
+        divResults *r);   // asmDiv .. asmUDivMod
+
+// a kernel that does asmMain on n packed values, like asmMainBatch
+typedef void (*packedBatchFunc)(const uint32_t *packed, int32_t *out, size_t n);
+
+// totals for one sweepPackedInputs run
+typedef struct _sweepResults
+{
+    uint64_t numVals;      // packed values checked
+    uint32_t mismatches;   // stops counting at UINT32_MAX
+    uint64_t cycles;       // DWT cycles for the whole sweep
+} sweepResults;
+
+
+    // *****************************************************************************
+    // *****************************************************************************
+    // Section: Interface Functions
+    // *****************************************************************************
+    // *****************************************************************************
+
+// adapters for the kernels in asmMult.s. kernel must have the same
+// type as the function named in the comment.
+void checkUnpackCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmUnpack
+void checkAbsCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmAbs, on both A and B
+void checkMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMult
+void checkFixSignCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmFixSign
+void checkMainCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMain, and the globals it sets
+
+// adapters for the other kernels, one per tc[] case
+void checkAbsPackedCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmAbsPacked
+void checkMultSwappedCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMult type, called as (b, a)
+void checkMainCtxCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMainCtx, with and without a ctx
+void checkMainSatCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMainSat, and the globals it sets
+// these take the packed values of tc[0..testNum] as one array, so every
+// length from 1 to the number of tc[] cases is tried
+void checkMainBatchCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMainBatch
+void checkDot16Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmDot16: each value times itself
+void checkMac16Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMac16: each value times the next
+
+// adapters with their own cases; the row's numCases is the constant named
+void checkMultQsqCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMultQsq, QSQ_TEST_CASES
+void checkQ15Case(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // q15GroupFunc, Q15_TEST_CASES
+void checkCmulCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmCmul, CMUL_TEST_CASES
+void checkCmulConjCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmCmulConj, CMUL_TEST_CASES
+void checkMultNCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmMultN, MULTN_TEST_CASES
+void checkKaratsubaCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // multNKaratsuba at threshold 2,
+                                      // MULTN_TEST_CASES
+void checkPukccMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // pukccMultN, PUKCC_TEST_CASES
+void checkPukccModMultCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // pukccModMultN, PUKCC_TEST_CASES
+void checkDivCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // divGroupFunc, DIV_TEST_CASES
+void checkUDivConstCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmUDivConst, DIV_CONST_TEST_CASES
+void checkUDivConstNCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // asmUDivConstN, DIV_CONST_TEST_CASES
+void checkFirCase(const kernelTest *t, int32_t testNum, expectedValues *exp,
+        int32_t *passCount, int32_t *failCount, bool onlyPrintFails,
+        volatile bool *txComplete);   // firProcess, FIR_TEST_CASES
+
+// run every enabled row of tests[0..numKernels) on each of the
+// numTestCases test cases, whose inputs and expected values are in
+// expected[] (see calcExpectedValuesN), or on its own numCases cases.
+// results[k] gets the totals for tests[k], all 0 for a disabled row.
+// Paced mode (turbo false) prints an in-progress summary after each case
+// and waits for *rtcExpired before the next one, so the output can be
+// read as it goes by. Turbo mode runs the cases back to back, times each
+// one, and prints one summary for all the kernels at the end, with the
+// wall-clock time of the whole run. A case's time is the whole adapter:
+// input setup, kernel and checker, so it is an upper bound on the kernel
+// (microBench.h has kernel-only cycles). Failures are printed in both
+// modes.
+// Returns the wall-clock time of the run in CPU cycles (it wraps after
+// 2^32 cycles, about 35 s at 120 MHz).
+uint32_t runKernelTests(
+        const kernelTest *tests,
+        kernelTestResults *results,
+        uint32_t numKernels,
+        expectedValues *expected,
+        uint32_t numTestCases,
+        bool onlyPrintFails,
+        bool turbo,
+        volatile bool *rtcExpired,
+        volatile bool *txComplete);
+
+// check kernel on every stride-th packed value: 0, stride, 2*stride, ...
+// up to 0xFFFFFFFF. stride 1 is all 2^32 of them. Nothing is printed per
+// value; the first few mismatches are printed in full, the rest only
+// counted, and a progress line with the running count and values/sec
+// goes out every 2^24 values without waiting on the UART.
+void sweepPackedInputs(
+        packedBatchFunc kernel,
+        const char *name,      // used in the progress lines
+        uint32_t stride,       // 1 or more
+        sweepResults *r,
+        volatile bool *txComplete);
+
+// check kernel on numBatches batches of random packed values, at full
+// speed like sweepPackedInputs. seed 0 takes a seed from the TRNG; any
+// other seed replays that sequence (randVectors.h). The seed is printed
+// before the run and again in the summary with the first failing batch.
+// The cycle count wraps after about 35 s of batches.
+void randomPackedTests(
+        packedBatchFunc kernel,
+        const char *name,      // used in the summaries
+        uint32_t seed,
+        uint32_t numBatches,   // of 256 values
+        sweepResults *r,
+        volatile bool *txComplete);
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TEST_RUNNER_H */
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,31 @@
+/* ************************************************************************** */
+/** Packed test vectors
+
+  @File Name
+    testVectors.c
+
+  @Summary
+    See testVectors.h.
+ */
+/* ************************************************************************** */
+
+#include <stdint.h>
+#include "testVectors.h"
+
+const int32_t tc[NUM_TEST_CASES] = {
+    0x00020003,
+    0xFFFC0003,  // -,+
+    0x00000000,  // 0,0
+    0x00000005,  // 0,+
+    0x0000FFFC,  // 0,-
+    0xFFFD0000,  // -,0
+    0x00020000,  // +,0
+    0x80008000,  // -,-
+    0xFFF3FFE0,  // -,-
+    0x7FF38001,  // +,-
+    0x7FF17FF2   // +,+
+};
+
+/* *****************************************************************************
+ End of File
+ */
@@ -0,0 +1,43 @@
+/* ************************************************************************** */
+/** Packed test vectors
+
+  @File Name
+    testVectors.h
+
+  @Summary
+    The tc[] packed values every kernel test runs on.
+
+  @Description
+    Each value holds two signed 16 bit operands, a in the upper half
+    and b in the lower one. main.c runs the kernel tests on them, and
+    the host build (testHost.c and the emulator tools) uses the same
+    file, so both always check the same cases.
+ */
+/* ************************************************************************** */
+
+#ifndef _TEST_VECTORS_H    /* Guard against multiple inclusion */
+#define _TEST_VECTORS_H
+
+#include <stdint.h>
+
+/* Provide C++ Compatibility */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_TEST_CASES 11
+
+// the following array defines pairs of {balance, transaction} values
+// tc stands for test case
+extern const int32_t tc[NUM_TEST_CASES];
+
+    /* Provide C++ Compatibility */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TEST_VECTORS_H */
+
+/* *****************************************************************************
+ End of File
+ */